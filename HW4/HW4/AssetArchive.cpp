@@ -0,0 +1,132 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <string.h>
+#include "AssetArchive.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+* Maps an archive into memory and reads its table of contents
+* Nothing is copied -- entry data stays in the mapping until close()
+*
+* @param filepath, an archive written by HW4Pack
+*
+* @return false if the file is missing or isn't a valid archive
+*/
+bool AssetArchive::open(const char* filepath)
+{
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER file_size;
+	GetFileSizeEx(file, &file_size);
+	HANDLE mapping = file_size.QuadPart > 0 ? CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+	CloseHandle(file);
+	if (mapping == NULL) return false;
+
+	m_mapping = mapping;
+	m_size = (size_t)file_size.QuadPart;
+	m_data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+	int file = ::open(filepath, O_RDONLY);
+	if (file < 0) return false;
+
+	struct stat file_info;
+	void* data = MAP_FAILED;
+	if (fstat(file, &file_info) == 0 && file_info.st_size > 0)
+	{
+		data = mmap(nullptr, (size_t)file_info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	}
+	::close(file);
+	if (data == MAP_FAILED) return false;
+
+	m_size = (size_t)file_info.st_size;
+	m_data = (const unsigned char*)data;
+#endif
+	if (m_data == nullptr)
+	{
+		close();
+		return false;
+	}
+
+	// check the header and every entry before trusting any of it
+	const ArchiveHeader* header = (const ArchiveHeader*)m_data;
+	if (m_size < sizeof(ArchiveHeader) || memcmp(header->magic, ARCHIVE_MAGIC, 4) != 0
+		|| header->version != ARCHIVE_VERSION
+		|| header->entry_count > (m_size - sizeof(ArchiveHeader)) / sizeof(ArchiveEntry))
+	{
+		close();
+		return false;
+	}
+
+	m_entries = (const ArchiveEntry*)(m_data + sizeof(ArchiveHeader));
+	for (uint32_t i = 0; i < header->entry_count; i++)
+	{
+		const ArchiveEntry& entry = m_entries[i];
+		bool valid = memchr(entry.name, '\0', ARCHIVE_NAME_LENGTH) != nullptr
+			&& entry.offset <= m_size && entry.size <= m_size - entry.offset
+			&& (entry.type != ARCHIVE_TEXTURE_RGBA || entry.size == (uint64_t)entry.width * entry.height * 4);
+		if (!valid)
+		{
+			close();
+			return false;
+		}
+		m_entries_by_name[entry.name] = (int)i;
+	}
+
+	return true;
+}
+
+void AssetArchive::close()
+{
+	if (m_data != nullptr)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(m_data);
+#else
+		munmap((void*)m_data, m_size);
+#endif
+	}
+#ifdef _WIN32
+	if (m_mapping != nullptr) CloseHandle((HANDLE)m_mapping);
+#endif
+
+	m_data = nullptr;
+	m_size = 0;
+	m_mapping = nullptr;
+	m_entries = nullptr;
+	m_entries_by_name.clear();
+}
+
+/*
+* Looks up an entry by the path the game would have loaded it from
+*
+* @param name, e.g. "font.png"
+*
+* @return nullptr if the archive doesn't have it
+*/
+const ArchiveEntry* AssetArchive::find(const char* name) const
+{
+	auto found = m_entries_by_name.find(name);
+	if (found == m_entries_by_name.end()) return nullptr;
+	return &m_entries[found->second];
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <stdint.h>
+
+/*
+* One file holding every texture and shader the game loads
+* Textures are stored already decoded as RGBA texels, so the game hands
+* pointers into the mapped file straight to glTexImage2D
+*
+* Layout (little-endian): ArchiveHeader, entry_count ArchiveEntry records,
+* then each entry's data starting on an ARCHIVE_ALIGNMENT boundary
+* Written offline by HW4Pack -- see AssetPacker.cpp
+*/
+
+const char     ARCHIVE_MAGIC[4] = { 'H', 'W', '4', 'A' };
+const uint32_t ARCHIVE_VERSION = 1;
+const int      ARCHIVE_NAME_LENGTH = 64;
+const int      ARCHIVE_ALIGNMENT = 16;
+
+enum ArchiveEntryType : uint32_t { ARCHIVE_TEXTURE_RGBA = 1, ARCHIVE_TEXT = 2 };
+
+struct ArchiveHeader
+{
+	char     magic[4];
+	uint32_t version;
+	uint32_t entry_count;
+	uint32_t reserved;
+};
+
+struct ArchiveEntry
+{
+	char     name[ARCHIVE_NAME_LENGTH]; // the path the game asks for, e.g. "shaders/vertex_textured.glsl"
+	uint32_t type;
+	uint32_t width;  // textures only
+	uint32_t height;
+	uint32_t reserved;
+	uint64_t offset; // from the start of the file
+	uint64_t size;   // in bytes
+};
+
+/*
+* Read-only view of an archive, memory-mapped for as long as it's open
+*/
+class AssetArchive
+{
+private:
+	const unsigned char* m_data = nullptr;
+	size_t m_size = 0;
+	void*  m_mapping = nullptr; // Windows file mapping handle
+
+	const ArchiveEntry* m_entries = nullptr;
+	std::unordered_map<std::string, int> m_entries_by_name;
+
+public:
+	AssetArchive() = default;
+	~AssetArchive() { close(); }
+
+	// the mapping is unmapped by the destructor, a copy would unmap it twice
+	AssetArchive(const AssetArchive&) = delete;
+	AssetArchive& operator=(const AssetArchive&) = delete;
+
+	bool open(const char* filepath);
+	void close();
+
+	const ArchiveEntry*  find(const char* name) const;
+	const unsigned char* get_data(const ArchiveEntry* entry) const { return m_data + entry->offset; };
+
+	// GETTERS
+	bool const is_open() const { return m_data != nullptr; };
+	int  const get_entry_count() const { return (int)m_entries_by_name.size(); };
+};
@@ -0,0 +1,195 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+/*
+* Offline packer for the game's asset archive
+* Decodes every .png in the asset folder to RGBA and copies every
+* .glsl under shaders/ as text, then writes them all into one archive
+*
+* usage: HW4Pack <asset folder> <archive>
+*   e.g. HW4Pack HW4/HW4 HW4/HW4/assets.pak
+* Re-run it whenever a PNG or shader changes -- the game prefers the archive
+*/
+
+#define STB_IMAGE_IMPLEMENTATION
+#define LOG(argument) std::cout << argument << '\n'
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string.h>
+#include <vector>
+#include "stb_image.h"
+#include "AssetArchive.h"
+
+namespace fs = std::filesystem;
+
+struct PackedAsset
+{
+	ArchiveEntry entry;
+	std::vector<unsigned char> data;
+};
+
+/*
+* Reads one file into an archive entry
+*
+* @param path, the file on disk
+* @param name, the path the game loads it by
+* @param asset, receives the entry and its data
+*
+* @return false if the file can't be read or the name doesn't fit
+*/
+bool pack_asset(const fs::path& path, const std::string& name, PackedAsset& asset)
+{
+	if (name.size() >= ARCHIVE_NAME_LENGTH)
+	{
+		LOG("Name too long for the archive: " << name);
+		return false;
+	}
+
+	memset(&asset.entry, 0, sizeof(ArchiveEntry));
+	strcpy(asset.entry.name, name.c_str());
+
+	if (path.extension() == ".png")
+	{
+		int width, height, number_of_components;
+		unsigned char* image = stbi_load(path.string().c_str(), &width, &height, &number_of_components, STBI_rgb_alpha);
+		if (image == NULL)
+		{
+			LOG("Unable to load image " << path.string());
+			return false;
+		}
+
+		asset.entry.type = ARCHIVE_TEXTURE_RGBA;
+		asset.entry.width = width;
+		asset.entry.height = height;
+		asset.data.assign(image, image + (size_t)width * height * 4);
+		stbi_image_free(image);
+	}
+	else
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			LOG("Unable to read " << path.string());
+			return false;
+		}
+
+		asset.entry.type = ARCHIVE_TEXT;
+		asset.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	asset.entry.size = asset.data.size();
+	return true;
+}
+
+/*
+* Every file the game loads, sorted so the same folder always packs the same way
+*
+* @param folder, the asset folder
+*/
+std::vector<std::string> find_assets(const fs::path& folder)
+{
+	std::vector<std::string> names;
+
+	for (const fs::directory_entry& file : fs::directory_iterator(folder))
+	{
+		if (file.is_regular_file() && file.path().extension() == ".png")
+		{
+			names.push_back(file.path().filename().string());
+		}
+	}
+
+	fs::path shaders = folder / "shaders";
+	if (fs::is_directory(shaders))
+	{
+		for (const fs::directory_entry& file : fs::directory_iterator(shaders))
+		{
+			if (file.is_regular_file() && file.path().extension() == ".glsl")
+			{
+				names.push_back("shaders/" + file.path().filename().string());
+			}
+		}
+	}
+
+	std::sort(names.begin(), names.end());
+	return names;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		LOG("usage: HW4Pack <asset folder> <archive>");
+		return 1;
+	}
+
+	fs::path folder = argv[1];
+	std::vector<std::string> names = find_assets(folder);
+
+	std::vector<PackedAsset> assets(names.size());
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		if (!pack_asset(folder / names[i], names[i], assets[i])) return 1;
+	}
+
+	// data goes after the table of contents, each entry aligned
+	uint64_t offset = sizeof(ArchiveHeader) + assets.size() * sizeof(ArchiveEntry);
+	for (PackedAsset& asset : assets)
+	{
+		offset = (offset + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT;
+		asset.entry.offset = offset;
+		offset += asset.entry.size;
+	}
+
+	ArchiveHeader header;
+	memcpy(header.magic, ARCHIVE_MAGIC, 4);
+	header.version = ARCHIVE_VERSION;
+	header.entry_count = (uint32_t)assets.size();
+	header.reserved = 0;
+
+	std::ofstream file(argv[2], std::ios::binary);
+	file.write((const char*)&header, sizeof(header));
+	for (const PackedAsset& asset : assets)
+	{
+		file.write((const char*)&asset.entry, sizeof(ArchiveEntry));
+	}
+	for (const PackedAsset& asset : assets)
+	{
+		while ((uint64_t)file.tellp() < asset.entry.offset) file.put('\0');
+		file.write((const char*)asset.data.data(), asset.data.size());
+	}
+	file.close();
+	if (!file)
+	{
+		LOG("Unable to write " << argv[2]);
+		return 1;
+	}
+
+	// read it back the way the game will
+	AssetArchive archive;
+	if (!archive.open(argv[2]) || archive.get_entry_count() != (int)assets.size())
+	{
+		LOG("Archive failed to read back: " << argv[2]);
+		return 1;
+	}
+
+	for (const PackedAsset& asset : assets)
+	{
+		const ArchiveEntry& entry = asset.entry;
+		if (entry.type == ARCHIVE_TEXTURE_RGBA) LOG(entry.name << "  " << entry.width << "x" << entry.height << "  " << entry.size << " bytes");
+		else LOG(entry.name << "  " << entry.size << " bytes");
+	}
+	LOG(assets.size() << " assets, " << offset << " bytes -> " << argv[2]);
+
+	return 0;
+}
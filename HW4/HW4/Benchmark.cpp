@@ -0,0 +1,831 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+/*
+* Benchmarks for the simulation library -- no window or GL context needed
+*
+* usage: HW4Bench [--json <file>] [section ...]
+*   sections: broadphase tiles rects collisions sweeps ai ticks stress snapshots -- all of them by default
+*   --json writes every number in the tables to one file, so runs can be compared commit to commit
+*   exits with 1 if any benchmark's result check fails
+*/
+
+#define LOG(argument) std::cout << argument << '\n'
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <math.h>
+#include "Entity.h"
+#include "EntityStore.h"
+#include "SpatialGrid.h"
+#include "GameState.h"
+#include "LevelGenerator.h"
+#include "Snapshot.h"
+
+// the O(n^2) loop is only timed for this many entities, then scaled up
+const int BRUTE_FORCE_SAMPLE = 1000;
+
+// roughly one entity for every DENSITY tiles
+const float DENSITY = 4.0f;
+
+typedef std::chrono::steady_clock Clock;
+
+double seconds_since(Clock::time_point start)
+{
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// one number from the tables, named section/case/metric
+struct BenchResult
+{
+	std::string name;
+	double value;
+	const char* unit;
+};
+
+std::vector<BenchResult> g_results;
+bool g_mismatch_found = false;
+
+void record_result(const std::string& name, double value, const char* unit)
+{
+	g_results.push_back({ name, value, unit });
+}
+
+/*
+* Writes every recorded result as JSON
+*
+* @param filepath, where to write them
+*
+* @return false if the file can't be written
+*/
+bool write_results(const char* filepath)
+{
+	std::ofstream file(filepath);
+	if (!file) return false;
+
+	file << std::setprecision(9);
+	file << "{\n\t\"matches\": " << (g_mismatch_found ? "false" : "true") << ",\n\t\"results\": [\n";
+	for (size_t i = 0; i < g_results.size(); i++)
+	{
+		file << "\t\t{ \"name\": \"" << g_results[i].name << "\", \"value\": ";
+		if (isfinite(g_results[i].value)) file << g_results[i].value;
+		else file << "null";
+		file << ", \"unit\": \"" << g_results[i].unit << "\" }" << (i + 1 < g_results.size() ? ",\n" : "\n");
+	}
+	file << "\t]\n}\n";
+	return file.good();
+}
+
+/*
+* Scatters entity_count 1x1 entities over a square area, with a fixed seed
+*
+* @param store, the ENTITYSTORE to put them in
+* @param entities, the views, one per entity
+* @param entity_count, number of entities
+*/
+void spawn_crowd(EntityStore& store, std::vector<Entity>& entities, int entity_count)
+{
+	std::mt19937 random(1234);
+	float side = sqrtf(entity_count * DENSITY);
+	std::uniform_real_distribution<float> coordinate(0.0f, side);
+
+	store.clear();
+	store.reserve(entity_count);
+	entities.assign(entity_count, Entity());
+	for (int i = 0; i < entity_count; i++)
+	{
+		entities[i].attach(&store);
+		entities[i].set_position(glm::vec3(coordinate(random), -coordinate(random), 0.0f));
+	}
+}
+
+/*
+* A long level -- ground four tiles deep with a grass row on top, plus floating platforms
+*
+* @param width, tiles across
+* @param height, tiles down
+* @param random, where the platforms go
+*
+* @return the tile ids, row by row
+*/
+std::vector<unsigned int> make_wide_level(int width, int height, std::mt19937& random)
+{
+	std::vector<unsigned int> level((size_t)width * height, 0);
+	for (int x = 0; x < width; x++)
+	{
+		level[(height - 5) * width + x] = 1;
+		for (int y = height - 4; y < height; y++) level[y * width + x] = 2;
+	}
+	for (int platform = 0; platform < width / 8; platform++)
+	{
+		int length = 3 + random() % 18;
+		int x = random() % (width - length);
+		int y = 8 + random() % (height - 16);
+		for (int i = 0; i < length; i++) level[y * width + x + i] = 1 + random() % 2 * (i == 0 || i == length - 1);
+	}
+	return level;
+}
+
+/*
+* Entity vs entity collision at 1k, 10k and 100k entities
+* Compares testing every pair against the SPATIALGRID broadphase
+*/
+void benchmark_broadphase()
+{
+	LOG("broadphase: entity vs entity, every entity against every other (grid ms = build + queries)");
+	LOG(std::setw(10) << "entities" << std::setw(16) << "brute force ms" << std::setw(12) << "grid ms"
+		<< std::setw(12) << "speedup" << std::setw(12) << "overlaps");
+
+	const int sizes[] = { 1000, 10000, 100000 };
+	for (int entity_count : sizes)
+	{
+		EntityStore store;
+		std::vector<Entity> entities;
+		spawn_crowd(store, entities, entity_count);
+
+		// BRUTE FORCE -- a strided sample of entities against all of them
+		int sample = std::min(entity_count, BRUTE_FORCE_SAMPLE);
+		int stride = entity_count / sample;
+		long brute_hits = 0;
+
+		Clock::time_point start = Clock::now();
+		for (int s = 0; s < sample; s++)
+		{
+			Entity* entity = &entities[s * stride];
+			for (int j = 0; j < entity_count; j++)
+			{
+				if (entity->check_collision(&entities[j])) brute_hits++;
+			}
+		}
+		double brute_seconds = seconds_since(start) * ((double)entity_count / sample);
+
+		// GRID -- build once, then query for every entity
+		SpatialGrid grid(1.0f);
+		long grid_hits = 0;
+		long sample_hits = 0;
+
+		start = Clock::now();
+		grid.build(entities.data(), entity_count);
+		for (int i = 0; i < entity_count; i++)
+		{
+			const std::vector<int>& candidates = grid.query(entities[i].get_position(), 1.0f, 1.0f);
+			for (int j : candidates)
+			{
+				if (entities[i].check_collision(&entities[j])) grid_hits++;
+			}
+		}
+		double grid_seconds = seconds_since(start);
+
+		// the grid must find exactly what brute force found for the sampled entities
+		for (int s = 0; s < sample; s++)
+		{
+			Entity* entity = &entities[s * stride];
+			for (int j : grid.query(entity->get_position(), 1.0f, 1.0f))
+			{
+				if (entity->check_collision(&entities[j])) sample_hits++;
+			}
+		}
+		if (sample_hits != brute_hits)
+		{
+			LOG("  MISMATCH: grid found " << sample_hits << ", brute force " << brute_hits);
+			g_mismatch_found = true;
+		}
+
+		LOG(std::setw(10) << entity_count << std::setw(16) << brute_seconds * 1000.0
+			<< std::setw(12) << grid_seconds * 1000.0 << std::setw(11) << brute_seconds / grid_seconds << "x"
+			<< std::setw(12) << grid_hits / 2);
+
+		std::string name = "broadphase/" + std::to_string(entity_count);
+		record_result(name + "/brute_force", brute_seconds * 1000.0, "ms");
+		record_result(name + "/grid", grid_seconds * 1000.0, "ms");
+		record_result(name + "/overlaps", (double)(grid_hits / 2), "pairs");
+	}
+}
+
+/*
+* Map::is_solid one point at a time against Map::is_solid_batch
+* Points are scattered over level 1 and a margin around it
+*/
+void benchmark_tile_queries()
+{
+	const int POINT_COUNT = 1000000;
+
+	Map map(LEVEL1_WIDTH, LEVEL1_HEIGHT, LEVEL_1_DATA, 0, 1.0f, 3, 1);
+
+	std::mt19937 random(99);
+	std::uniform_real_distribution<float> coordinate_x(map.get_left_bound() - 1.0f, map.get_right_bound() + 1.0f);
+	std::uniform_real_distribution<float> coordinate_y(map.get_bottom_bound() - 1.0f, map.get_top_bound() + 1.0f);
+
+	std::vector<float> x(POINT_COUNT), y(POINT_COUNT);
+	for (int i = 0; i < POINT_COUNT; i++)
+	{
+		x[i] = coordinate_x(random);
+		y[i] = coordinate_y(random);
+	}
+
+	std::vector<float> scalar_x(POINT_COUNT), scalar_y(POINT_COUNT);
+	std::vector<char>  scalar_solid(POINT_COUNT);
+
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < POINT_COUNT; i++)
+	{
+		scalar_solid[i] = map.is_solid(glm::vec3(x[i], y[i], 0.0f), &scalar_x[i], &scalar_y[i]);
+	}
+	double scalar_seconds = seconds_since(start);
+
+	std::vector<float> batch_x(POINT_COUNT), batch_y(POINT_COUNT);
+	bool* batch_solid = new bool[POINT_COUNT];
+
+	start = Clock::now();
+	map.is_solid_batch(x.data(), y.data(), POINT_COUNT, batch_solid, batch_x.data(), batch_y.data());
+	double batch_seconds = seconds_since(start);
+
+	int mismatches = 0;
+	for (int i = 0; i < POINT_COUNT; i++)
+	{
+		if ((bool)scalar_solid[i] != batch_solid[i] || scalar_x[i] != batch_x[i] || scalar_y[i] != batch_y[i]) mismatches++;
+	}
+	delete[] batch_solid;
+
+	LOG("");
+	LOG("tile queries: " << POINT_COUNT << " points against level 1");
+	LOG(std::setw(24) << "is_solid ms" << std::setw(12) << scalar_seconds * 1000.0
+		<< std::setw(12) << POINT_COUNT / scalar_seconds / 1e6 << " Mpoints/s");
+	LOG(std::setw(24) << "is_solid_batch ms" << std::setw(12) << batch_seconds * 1000.0
+		<< std::setw(12) << POINT_COUNT / batch_seconds / 1e6 << " Mpoints/s");
+	if (mismatches > 0)
+	{
+		LOG("  MISMATCH: " << mismatches << " points differ");
+		g_mismatch_found = true;
+	}
+
+	record_result("tiles/is_solid", scalar_seconds / POINT_COUNT * 1e9, "ns/point");
+	record_result("tiles/is_solid_batch", batch_seconds / POINT_COUNT * 1e9, "ns/point");
+}
+
+/*
+* Merged tiles against single tiles, on level 1 and a long generated level --
+* quads the render mesh needs, and how many collision candidates a box query
+* turns up as solid tiles versus merged rectangles
+*/
+void benchmark_solid_rects()
+{
+	const int QUERY_COUNT = 1000000;
+	const int WIDE_WIDTH = 4096;
+	const int WIDE_HEIGHT = 64;
+
+	std::mt19937 random(5);
+	std::vector<unsigned int> wide_level = make_wide_level(WIDE_WIDTH, WIDE_HEIGHT, random);
+
+	Map level_1(LEVEL1_WIDTH, LEVEL1_HEIGHT, LEVEL_1_DATA, 0, 1.0f, 3, 1);
+	Map wide(WIDE_WIDTH, WIDE_HEIGHT, wide_level.data(), 0, 1.0f, 3, 1);
+
+	LOG("");
+	LOG("merged tiles: " << QUERY_COUNT << " box queries of 1 to 8 tiles a side");
+	LOG(std::setw(24) << "level" << std::setw(12) << "tiles" << std::setw(12) << "quads"
+		<< std::setw(12) << "rects" << std::setw(14) << "tile cands" << std::setw(14) << "rect cands"
+		<< std::setw(12) << "query ns");
+
+	for (Map* map : { &level_1, &wide })
+	{
+		int tile_total = 0;
+		for (int tile = 0; tile < map->get_width() * map->get_height(); tile++) tile_total += map->get_level_data()[tile] != 0;
+
+		// the render mesh merges identical tiles only
+		int quad_total = 0;
+		std::vector<TileRect> rects;
+		for (int chunk_y = 0; chunk_y < map->get_chunk_count_y(); chunk_y++)
+		{
+			for (int chunk_x = 0; chunk_x < map->get_chunk_count_x(); chunk_x++)
+			{
+				map->merge_tiles(chunk_x, chunk_y, true, rects);
+				quad_total += (int)rects.size();
+			}
+		}
+
+		std::uniform_real_distribution<float> coordinate_x(map->get_left_bound(), map->get_right_bound());
+		std::uniform_real_distribution<float> coordinate_y(map->get_bottom_bound(), map->get_top_bound());
+		std::uniform_real_distribution<float> size(1.0f, 8.0f);
+
+		std::vector<glm::vec3> centres(QUERY_COUNT);
+		std::vector<float> widths(QUERY_COUNT), heights(QUERY_COUNT);
+		for (int i = 0; i < QUERY_COUNT; i++)
+		{
+			centres[i] = glm::vec3(coordinate_x(random), coordinate_y(random), 0.0f);
+			widths[i] = size(random);
+			heights[i] = size(random);
+		}
+
+		long rect_candidates = 0;
+		Clock::time_point start = Clock::now();
+		for (int i = 0; i < QUERY_COUNT; i++)
+		{
+			map->query_solid_rects(centres[i], widths[i], heights[i], rects);
+			rect_candidates += (long)rects.size();
+		}
+		double query_seconds = seconds_since(start);
+
+		// what a tile by tile broadphase would hand on -- and a check that the
+		// rectangles cover exactly those tiles
+		long tile_candidates = 0;
+		int mismatches = 0;
+		for (int i = 0; i < QUERY_COUNT / 100; i++)
+		{
+			float half = map->get_tile_size() / 2;
+			int left = (int)floor((centres[i].x - widths[i] / 2 + half) / map->get_tile_size());
+			int right = (int)ceil((centres[i].x + widths[i] / 2 + half) / map->get_tile_size()) - 1;
+			int top = (int)floor((-(centres[i].y + heights[i] / 2) + half) / map->get_tile_size());
+			int bottom = (int)ceil((-(centres[i].y - heights[i] / 2) + half) / map->get_tile_size()) - 1;
+
+			map->query_solid_rects(centres[i], widths[i], heights[i], rects);
+			long covered = 0;
+			for (const TileRect& rect : rects)
+			{
+				covered += (long)(std::min(rect.x + rect.width - 1, right) - std::max(rect.x, left) + 1)
+					* (std::min(rect.y + rect.height - 1, bottom) - std::max(rect.y, top) + 1);
+			}
+
+			long solid = 0;
+			for (int y = std::max(top, 0); y <= std::min(bottom, map->get_height() - 1); y++)
+			{
+				for (int x = std::max(left, 0); x <= std::min(right, map->get_width() - 1); x++) solid += map->is_solid_tile(x, y);
+			}
+			tile_candidates += solid;
+			if (covered != solid) mismatches++;
+		}
+
+		LOG(std::setw(24) << (map == &level_1 ? "level 1" : "generated 4096x64") << std::setw(12) << tile_total
+			<< std::setw(12) << quad_total << std::setw(12) << map->get_solid_rect_count()
+			<< std::setw(14) << tile_candidates / (double)(QUERY_COUNT / 100)
+			<< std::setw(14) << rect_candidates / (double)QUERY_COUNT
+			<< std::setw(12) << query_seconds / QUERY_COUNT * 1e9);
+		if (mismatches > 0)
+		{
+			LOG("  MISMATCH: " << mismatches << " queries cover the wrong tiles");
+			g_mismatch_found = true;
+		}
+
+		std::string name = map == &level_1 ? "rects/level_1" : "rects/generated_4096x64";
+		record_result(name + "/quads", quad_total, "quads");
+		record_result(name + "/rects", map->get_solid_rect_count(), "rects");
+		record_result(name + "/query", query_seconds / QUERY_COUNT * 1e9, "ns/query");
+	}
+}
+
+/*
+* Map::sweep for boxes thrown across level 1, plus the cases it has to get right --
+* a box running diagonally into the exact corner of a tile, and entities falling
+* and jumping fast enough to skip row 1 in one step
+*/
+void benchmark_sweeps()
+{
+	const int SWEEP_COUNT = 1000000;
+
+	Map map(LEVEL1_WIDTH, LEVEL1_HEIGHT, LEVEL_1_DATA, 0, 1.0f, 3, 1);
+
+	std::mt19937 random(31);
+	std::uniform_real_distribution<float> coordinate_x(map.get_left_bound(), map.get_right_bound());
+	std::uniform_real_distribution<float> coordinate_y(map.get_bottom_bound(), map.get_top_bound());
+	std::uniform_real_distribution<float> move(-8.0f, 8.0f);
+
+	std::vector<glm::vec3> positions(SWEEP_COUNT), displacements(SWEEP_COUNT);
+	for (int i = 0; i < SWEEP_COUNT; i++)
+	{
+		positions[i] = glm::vec3(coordinate_x(random), coordinate_y(random), 0.0f);
+		displacements[i] = glm::vec3(move(random), move(random), 0.0f);
+	}
+
+	int hits = 0;
+	float time_of_impact;
+	glm::vec3 normal;
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < SWEEP_COUNT; i++)
+	{
+		hits += map.sweep(positions[i], 1.0f, 1.0f, displacements[i], &time_of_impact, &normal);
+	}
+	double sweep_seconds = seconds_since(start);
+
+	std::vector<std::string> failures;
+
+	// left edge of the box reaches column 0 and its bottom reaches the floor row at t = 4 / 30
+	bool hit = map.sweep(glm::vec3(-5.0f, 1.0f, 0.0f), 1.0f, 1.0f, glm::vec3(30.0f, -30.0f, 0.0f), &time_of_impact, &normal);
+	if (!hit || fabs(time_of_impact - 4.0f / 30.0f) > 1e-5f || normal != glm::vec3(0.0f, 1.0f, 0.0f))
+	{
+		failures.push_back("diagonal into a corner hit at t = " + std::to_string(time_of_impact));
+	}
+
+	// column 2 of row 1 is solid -- an entity three tiles a step either way has to stop at it,
+	// opted in to continuous collision or not
+	EntityStore store;
+	for (bool continuous : { true, false })
+	{
+		for (float direction : { -1.0f, 1.0f })
+		{
+			Entity entity;
+			entity.attach(&store);
+			entity.activate();
+			entity.set_width(1.0f);
+			entity.set_height(1.0f);
+			entity.set_position(glm::vec3(2.0f, direction < 0.0f ? 0.0f : -2.5f, 0.0f));
+			entity.set_velocity(glm::vec3(0.0f, direction * 3.0f / FIXED_TIMESTEP, 0.0f));
+			entity.set_continuous_collision(continuous);
+			entity.finish_update(FIXED_TIMESTEP, nullptr, 0, &map);
+
+			bool stopped = direction < 0.0f ? entity.get_position().y >= 0.0f && entity.get_collided_bottom()
+				: entity.get_position().y <= -2.0f && entity.get_collided_top();
+			if (!stopped)
+			{
+				failures.push_back(std::string(direction < 0.0f ? "falling" : "jumping") + (continuous ? " opted in" : " not opted in")
+					+ " ended at y = " + std::to_string(entity.get_position().y));
+			}
+		}
+	}
+
+	LOG("");
+	LOG("sweeps: " << SWEEP_COUNT << " 1x1 boxes moving up to 8 tiles across level 1");
+	LOG(std::setw(24) << "sweep ns" << std::setw(12) << sweep_seconds / SWEEP_COUNT * 1e9
+		<< std::setw(12) << hits << " hits");
+	for (const std::string& failure : failures)
+	{
+		LOG("  MISMATCH: " << failure);
+		g_mismatch_found = true;
+	}
+
+	record_result("sweeps/sweep", sweep_seconds / SWEEP_COUNT * 1e9, "ns/sweep");
+}
+
+/*
+* Entity::check_collision over every pair of a crowd, then check_collision_y
+* and check_collision_x against a generated level for entities scattered
+* through it -- positions and velocities are put back before every pass
+*/
+void benchmark_collisions()
+{
+	const int PAIR_CROWD = 2000;
+	const int MAP_ENTITIES = 100000;
+	const int MAP_PASSES = 20;
+
+	EntityStore store;
+	std::vector<Entity> entities;
+	spawn_crowd(store, entities, PAIR_CROWD);
+
+	long overlaps = 0;
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < PAIR_CROWD; i++)
+	{
+		for (int j = 0; j < PAIR_CROWD; j++)
+		{
+			if (entities[i].check_collision(&entities[j])) overlaps++;
+		}
+	}
+	double pair_seconds = seconds_since(start);
+	double pair_count = (double)PAIR_CROWD * PAIR_CROWD;
+
+	std::mt19937 random(17);
+	std::vector<unsigned int> level = make_wide_level(4096, 64, random);
+	Map map(4096, 64, level.data(), 0, 1.0f, 3, 1);
+
+	std::uniform_real_distribution<float> coordinate_x(map.get_left_bound(), map.get_right_bound());
+	std::uniform_real_distribution<float> coordinate_y(map.get_bottom_bound(), map.get_top_bound());
+	std::uniform_real_distribution<float> speed(-4.0f, 4.0f);
+
+	spawn_crowd(store, entities, MAP_ENTITIES);
+	std::vector<glm::vec3> start_positions(MAP_ENTITIES), start_velocities(MAP_ENTITIES);
+	for (int i = 0; i < MAP_ENTITIES; i++)
+	{
+		start_positions[i] = glm::vec3(coordinate_x(random), coordinate_y(random), 0.0f);
+		start_velocities[i] = glm::vec3(speed(random), speed(random), 0.0f);
+	}
+
+	double axis_seconds[2] = { 0.0, 0.0 };
+	long axis_hits[2] = { 0, 0 };
+	for (int pass = 0; pass < MAP_PASSES; pass++)
+	{
+		for (int axis = 0; axis < 2; axis++)
+		{
+			for (int i = 0; i < MAP_ENTITIES; i++)
+			{
+				entities[i].set_position(start_positions[i]);
+				entities[i].set_velocity(start_velocities[i]);
+				store.flags[i] = FLAG_ACTIVE;
+			}
+
+			start = Clock::now();
+			if (axis == 0) for (Entity& entity : entities) entity.check_collision_y(&map);
+			else for (Entity& entity : entities) entity.check_collision_x(&map);
+			axis_seconds[axis] += seconds_since(start);
+
+			for (int i = 0; i < MAP_ENTITIES; i++) axis_hits[axis] += (store.flags[i] & FLAG_COLLIDED_ANY) != 0;
+		}
+	}
+
+	double checks = (double)MAP_ENTITIES * MAP_PASSES;
+
+	LOG("");
+	LOG("collisions: " << PAIR_CROWD << " entities pairwise, " << MAP_ENTITIES << " entities against a 4096x64 level");
+	LOG(std::setw(24) << "check_collision ns" << std::setw(12) << pair_seconds / pair_count * 1e9
+		<< std::setw(12) << overlaps / 2 << " overlaps");
+	LOG(std::setw(24) << "check_collision_y ns" << std::setw(12) << axis_seconds[0] / checks * 1e9
+		<< std::setw(12) << axis_hits[0] / checks * 100.0 << " % hit");
+	LOG(std::setw(24) << "check_collision_x ns" << std::setw(12) << axis_seconds[1] / checks * 1e9
+		<< std::setw(12) << axis_hits[1] / checks * 100.0 << " % hit");
+
+	record_result("collisions/check_collision", pair_seconds / pair_count * 1e9, "ns/pair");
+	record_result("collisions/check_collision_y_map", axis_seconds[0] / checks * 1e9, "ns/entity");
+	record_result("collisions/check_collision_x_map", axis_seconds[1] / checks * 1e9, "ns/entity");
+}
+
+/*
+* Each AI script on its own, run over a crowd of that animatronic
+* The player paces back and forth along the crowd's row, turning round and
+* switching between walking and sneaking, so the scripts change state as in play
+*/
+void benchmark_ai()
+{
+	const int ENEMIES = 10000;
+	const int TICKS = 300;
+	const AIType types[] = { FREDDY, BONNIE, CHICA, FOXY };
+	const char* names[] = { "ai_teleport", "ai_patrol", "ai_stealth_activate", "ai_peekaboo" };
+
+	LOG("");
+	LOG("AI scripts: " << ENEMIES << " enemies of one type for " << TICKS << " ticks");
+	LOG(std::setw(24) << "script" << std::setw(12) << "ns/call" << std::setw(12) << "chasing");
+
+	for (int type = 0; type < 4; type++)
+	{
+		EntityStore store;
+		std::vector<Entity> enemies;
+		spawn_crowd(store, enemies, ENEMIES);
+
+		std::mt19937 random(31 + type);
+		std::uniform_real_distribution<float> timer(0.0f, 2.0f);
+		for (Entity& enemy : enemies)
+		{
+			enemy.set_entity_type(ENEMY);
+			enemy.set_ai_type(types[type]);
+			enemy.set_ai_state(IDLE);
+			enemy.set_speeds(.50f, 2.0f, 0.25f);
+			enemy.set_position(glm::vec3(enemy.get_position().x, 0.0f, 0.0f));
+			enemy.ability_timer = timer(random);
+		}
+
+		Entity player;
+		player.attach(&store);
+		player.set_entity_type(PLAYER);
+		float row_length = sqrtf(ENEMIES * DENSITY);
+
+		double seconds = 0.0;
+		for (int tick = 0; tick < TICKS; tick++)
+		{
+			// a lap of the row every 100 ticks, sneaking on every other lap
+			float lap = (tick % 100) / 100.0f;
+			player.is_facing_right = (tick / 50) % 2 == 0;
+			player.set_position(glm::vec3(row_length * (player.is_facing_right ? lap : 1.0f - lap), 0.0f, 0.0f));
+			player.set_movement_state((tick / 100) % 2 == 0 ? WALK : SNEAK);
+
+			Clock::time_point start = Clock::now();
+			switch (types[type])
+			{
+			case FREDDY:
+				for (Entity& enemy : enemies) enemy.ai_teleport(&player, FIXED_TIMESTEP);
+				break;
+			case BONNIE:
+				for (Entity& enemy : enemies) enemy.ai_patrol(&player, FIXED_TIMESTEP);
+				break;
+			case CHICA:
+				for (Entity& enemy : enemies) enemy.ai_stealth_activate(&player);
+				break;
+			case FOXY:
+				for (Entity& enemy : enemies) enemy.ai_peekaboo(&player);
+				break;
+			}
+			seconds += seconds_since(start);
+		}
+
+		int chasing = 0;
+		for (Entity& enemy : enemies) chasing += enemy.get_ai_state() == CHASING;
+
+		double ns_per_call = seconds / ((double)ENEMIES * TICKS) * 1e9;
+		LOG(std::setw(24) << names[type] << std::setw(12) << ns_per_call << std::setw(12) << chasing);
+		record_result(std::string("ai/") + names[type], ns_per_call, "ns/call");
+	}
+}
+
+/*
+* Whole fixed steps through step_game_state -- level 1, then growing crowds of
+* every animatronic on a generated 1000x100 level
+*/
+void benchmark_ticks()
+{
+	const int LEVEL_1_TICKS = 100000;
+	const int CROWD_SIZES[] = { 100, 1000, 10000, 100000 };
+
+	LOG("");
+	LOG("ticks: a whole fixed step");
+	LOG(std::setw(24) << "enemies" << std::setw(12) << "ticks" << std::setw(12) << "us/tick"
+		<< std::setw(14) << "ns/entity");
+
+	GameState state;
+	initialise_game_state(state, 0);
+	Clock::time_point start = Clock::now();
+	for (int tick = 0; tick < LEVEL_1_TICKS; tick++) step_game_state(state);
+	double seconds = seconds_since(start);
+	shutdown_game_state(state);
+
+	LOG(std::setw(24) << "level 1" << std::setw(12) << LEVEL_1_TICKS << std::setw(12) << seconds / LEVEL_1_TICKS * 1e6
+		<< std::setw(14) << seconds / LEVEL_1_TICKS / (ENEMY_COUNT + 1) * 1e9);
+	record_result("ticks/level_1", seconds / LEVEL_1_TICKS * 1e6, "us/tick");
+
+	for (int enemy_count : CROWD_SIZES)
+	{
+		LevelConfig config;
+		config.enemies_per_type = enemy_count / 4;
+		GeneratedLevel level;
+		generate_level(config, level);
+		initialise_generated_state(state, level, 0);
+
+		int ticks = std::max(20, 2000000 / enemy_count);
+		start = Clock::now();
+		for (int tick = 0; tick < ticks; tick++) step_game_state(state);
+		seconds = seconds_since(start);
+		shutdown_game_state(state);
+
+		LOG(std::setw(24) << enemy_count << std::setw(12) << ticks << std::setw(12) << seconds / ticks * 1e6
+			<< std::setw(14) << seconds / ticks / (enemy_count + 1) * 1e9);
+		record_result("ticks/" + std::to_string(enemy_count), seconds / ticks * 1e6, "us/tick");
+	}
+}
+
+/*
+* Level and crowd growing together through STRESS_LEVELS -- time to generate,
+* memory held by the map and the entities, and tick time
+*/
+void benchmark_stress()
+{
+	LOG("");
+	LOG("stress levels: generated, then stepped");
+	LOG(std::setw(24) << "level" << std::setw(12) << "enemies" << std::setw(14) << "generate ms"
+		<< std::setw(12) << "map MB" << std::setw(12) << "entity MB" << std::setw(12) << "ms/tick");
+
+	for (int preset = 0; preset < STRESS_LEVEL_COUNT; preset++)
+	{
+		const LevelConfig& config = STRESS_LEVELS[preset];
+
+		Clock::time_point start = Clock::now();
+		GeneratedLevel level;
+		generate_level(config, level);
+		GameState state;
+		initialise_generated_state(state, level, 0, config.seed);
+		double generate_seconds = seconds_since(start);
+
+		double map_megabytes = state.map->get_collision_bytes() / 1048576.0;
+		double entity_megabytes = (state.store->get_bytes() + (state.enemy_count + 3) * sizeof(Entity)) / 1048576.0;
+
+		int ticks = std::max(10, 200000 / state.enemy_count);
+		start = Clock::now();
+		for (int tick = 0; tick < ticks; tick++) step_game_state(state);
+		double seconds = seconds_since(start);
+
+		std::string size = std::to_string(config.width) + "x" + std::to_string(config.height);
+		LOG(std::setw(24) << size << std::setw(12) << state.enemy_count << std::setw(14) << generate_seconds * 1000.0
+			<< std::setw(12) << map_megabytes << std::setw(12) << entity_megabytes << std::setw(12) << seconds / ticks * 1000.0);
+
+		record_result("stress/" + size + "/generate", generate_seconds * 1000.0, "ms");
+		record_result("stress/" + size + "/map_memory", map_megabytes, "MB");
+		record_result("stress/" + size + "/entity_memory", entity_megabytes, "MB");
+		record_result("stress/" + size + "/tick", seconds / ticks * 1000.0, "ms/tick");
+
+		shutdown_game_state(state);
+	}
+}
+
+/*
+* Cost of saving and restoring level 1 through a SNAPSHOTRING
+* Also rolls back and re-steps to check the restored state matches
+*/
+void benchmark_snapshots()
+{
+	const int RING_TICKS = 600;
+	const int REPEATS = 1000000;
+
+	GameState state;
+	initialise_game_state(state, 0);
+	SnapshotRing ring(state, RING_TICKS);
+
+	// fill the ring with real ticks, remembering the hash of each one
+	std::vector<uint64_t> hashes;
+	for (int tick = 0; tick < RING_TICKS; tick++)
+	{
+		ring.save(state);
+		hashes.push_back(hash_game_state(state));
+		step_game_state(state);
+	}
+	uint64_t final_hash = hash_game_state(state);
+
+	// roll back halfway and step forward again -- must land on the same state
+	long rollback_tick = ring.get_oldest_tick() + RING_TICKS / 2;
+	bool matches = ring.restore(state, rollback_tick) && hash_game_state(state) == hashes[rollback_tick];
+	while (state.tick < RING_TICKS)
+	{
+		ring.save(state);
+		step_game_state(state);
+	}
+	matches = matches && hash_game_state(state) == final_hash;
+
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < REPEATS; i++)
+	{
+		ring.save(state);
+	}
+	double save_seconds = seconds_since(start);
+
+	long newest_tick = ring.get_newest_tick();
+	start = Clock::now();
+	for (int i = 0; i < REPEATS; i++)
+	{
+		ring.restore(state, newest_tick);
+	}
+	double restore_seconds = seconds_since(start);
+
+	LOG("");
+	LOG("snapshots: level 1, " << ring.get_snapshot_bytes() << " bytes each, ring of " << RING_TICKS << " ticks");
+	LOG(std::setw(24) << "save ns" << std::setw(12) << save_seconds / REPEATS * 1e9);
+	LOG(std::setw(24) << "restore ns" << std::setw(12) << restore_seconds / REPEATS * 1e9);
+	if (!matches)
+	{
+		LOG("  MISMATCH: rollback did not reproduce the original ticks");
+		g_mismatch_found = true;
+	}
+
+	record_result("snapshots/save", save_seconds / REPEATS * 1e9, "ns");
+	record_result("snapshots/restore", restore_seconds / REPEATS * 1e9, "ns");
+
+	shutdown_game_state(state);
+}
+
+struct BenchSection
+{
+	const char* name;
+	void (*run)();
+};
+
+const BenchSection SECTIONS[] =
+{
+	{ "broadphase", benchmark_broadphase },
+	{ "tiles", benchmark_tile_queries },
+	{ "rects", benchmark_solid_rects },
+	{ "collisions", benchmark_collisions },
+	{ "sweeps", benchmark_sweeps },
+	{ "ai", benchmark_ai },
+	{ "ticks", benchmark_ticks },
+	{ "stress", benchmark_stress },
+	{ "snapshots", benchmark_snapshots },
+};
+
+int main(int argc, char* argv[])
+{
+	const char* json_filepath = nullptr;
+	std::vector<std::string> chosen;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string option = argv[i];
+		if (option == "--json" && i + 1 < argc) json_filepath = argv[++i];
+		else chosen.push_back(option);
+	}
+
+	for (const std::string& name : chosen)
+	{
+		bool known = false;
+		for (const BenchSection& section : SECTIONS) known = known || name == section.name;
+		if (!known)
+		{
+			LOG("usage: HW4Bench [--json <file>] [broadphase tiles rects collisions sweeps ai ticks stress snapshots]");
+			return 1;
+		}
+	}
+
+	for (const BenchSection& section : SECTIONS)
+	{
+		if (chosen.empty() || std::find(chosen.begin(), chosen.end(), section.name) != chosen.end()) section.run();
+	}
+
+	if (json_filepath != nullptr && !write_results(json_filepath))
+	{
+		LOG("Unable to write " << json_filepath);
+		return 1;
+	}
+	return g_mismatch_found ? 1 : 0;
+}
@@ -8,20 +8,11 @@
 * Academic Misconduct.
 **/
 
-#define GL_SILENCE_DEPRECATION
-#define STB_IMAGE_IMPLEMENTATION
-
-#ifdef _WINDOWS
-#include <GL/glew.h>
-#endif
-
-#define GL_GLEXT_PROTOTYPES 1
-#include <SDL.h>
-#include <SDL_opengl.h>
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
-#include "ShaderProgram.h"
 #include "Entity.h"
+#include "Snapshot.h"
+#include "Profiler.h"
 
 
 /*
@@ -29,17 +20,18 @@
 */
 Entity::Entity()
 {
-    // position and tranformation variables
-    m_position = glm::vec3(0.0f);
-    m_model_matrix = glm::mat4(1.0f);
-
-    // physics variables
-    m_velocity = glm::vec3(0.0f);
-    m_acceleration = glm::vec3(0.0f);
-    m_movement = glm::vec3(0.0f);
+}
 
-    // ENTITY-specific variables
-    current_speed = 0;
+/*
+* Points this ENTITY at a fresh slot in the STORE
+* The slot starts at the old constructor defaults -- origin, no physics, active
+*
+* @param store, the ENTITYSTORE that holds this ENTITY's physics data
+*/
+void Entity::attach(EntityStore* store)
+{
+    m_store = store;
+    m_index = store->create();
 }
 
 /*
@@ -53,51 +45,83 @@ Entity::Entity()
 * @param objects, an array of entities that this ENTITY can collide with
 * @param object_count, size of the array mentioned above
 * @param map, the level's MAP object that the entity can collide with
+* @param grid, optional broadphase built from objects -- only nearby objects are tested
 */
-void Entity::update(float delta_time, Entity* player, Entity* objects, int object_count, Map* map)
+void Entity::update(float delta_time, Entity* player, Entity* objects, int object_count, Map* map,
+    SpatialGrid* grid)
 {
+    PROFILE_SCOPE("Entity::update");
     // if not active -- then can't update, treat like deletion
-    if (!m_is_active) return;
-    if (m_entity_type == ENEMY) ai_activate(player, delta_time);
+    if (!is_active()) return;
 
-    m_collided_top = false;
-    m_collided_bottom = false;
-    m_collided_left = false;
-    m_collided_right = false;
+    begin_update(delta_time, player);
+    m_store->integrate_velocities(m_index, 1, delta_time);
+    finish_update(delta_time, objects, object_count, map, grid);
+}
 
-    m_velocity.x = m_movement.x * current_speed;
-    m_velocity += m_acceleration * delta_time; // velocity equation implemented in code
+/*
+* First part of update -- runs the AI for enemies
+* Must be followed by EntityStore::integrate_velocities and finish_update
+*
+* @param delta_time, float that's the value of real-life time in seconds
+* @param player, the player ENTITY -- mainly used by enemies
+*/
+void Entity::begin_update(float delta_time, Entity* player)
+{
+    PROFILE_SCOPE("Entity::begin_update");
+    if (!is_active()) return;
+    if (m_entity_type == ENEMY) ai_activate(player, delta_time);
+}
+
+/*
+* Last part of update -- moves the ENTITY and resolves collisions
+* Expects velocity to already be integrated for this tick
+*
+* @param delta_time, float that's the value of real-life time in seconds
+* @param objects, an array of entities that this ENTITY can collide with
+* @param object_count, size of the array mentioned above
+* @param map, the level's MAP object that the entity can collide with
+* @param grid, optional broadphase built from objects -- only nearby objects are tested
+*/
+void Entity::finish_update(float delta_time, Entity* objects, int object_count, Map* map,
+    SpatialGrid* grid)
+{
+    PROFILE_SCOPE("Entity::finish_update");
+    if (!is_active()) return;
 
     // must be calculated seperatedly for seperate collisions
-    m_position.y += m_velocity.y * delta_time;
-    check_collision_y(objects, object_count);
+    // fast movers stop at the first tile they would pass through, then the usual checks run
+    // a step longer than a tile always sweeps, whether the ENTITY opted in or not
+    float tile_size = map->get_tile_size();
+    glm::vec3 step_y = glm::vec3(0.0f, velocity().y * delta_time, 0.0f);
+    if (m_continuous_collision || fabs(step_y.y) > tile_size) step_y *= sweep_map(map, step_y);
+    position().y += step_y.y;
+    check_collision_y(objects, object_count, grid);
     check_collision_y(map);
 
-    m_position.x += m_velocity.x * delta_time;
-    check_collision_x(objects, object_count);
+    glm::vec3 step_x = glm::vec3(velocity().x * delta_time, 0.0f, 0.0f);
+    if (m_continuous_collision || fabs(step_x.x) > tile_size) step_x *= sweep_map(map, step_x);
+    position().x += step_x.x;
+    check_collision_x(objects, object_count, grid);
     check_collision_x(map);
 
-    // reset model before every change
-    m_model_matrix = glm::mat4(1.0f);
-    m_model_matrix = glm::translate(m_model_matrix, m_position);
-
     //  JUMPING  //
     if (m_is_jumping)
     {
         m_is_jumping = false;
-        m_velocity.y += m_jumping_power;
+        velocity().y += m_jumping_power;
     }
 
     switch (movement_state)
     {
     case WALK:
-        current_speed = m_walk_speed;
+        current_speed() = m_walk_speed;
         break;
     case SPRINT:
-        current_speed = m_sprint_speed;
+        current_speed() = m_sprint_speed;
         break;
     case SNEAK:
-        current_speed = m_sneak_speed;
+        current_speed() = m_sneak_speed;
         break;
     default:
         break;
@@ -112,28 +136,36 @@ void Entity::update(float delta_time, Entity* player, Entity* objects, int objec
 * 
 * @param collidable_entities, an array of all entities that this ENTITY can collide with
 * @param collidable_entity_count, size of the array above
+* @param grid, optional broadphase built from collidable_entities -- skips far away ones
 * 
 * TREAT LIKE ON_COLLISION_ENTER
 */
-void const Entity::check_collision_y(Entity* collidable_entities, int collidable_entity_count)
+void const Entity::check_collision_y(Entity* collidable_entities, int collidable_entity_count, SpatialGrid* grid)
 {
-    for (int i = 0; i < collidable_entity_count; i++)
+    PROFILE_SCOPE("Entity::check_collision_y entities");
+    // candidates come back in ascending order, the same order the full loop visits them in --
+    // but the grid is queried once, at the starting position, so an entity only
+    // pushed into reach by an earlier overlap isn't tested
+    const std::vector<int>* candidates = grid ? &grid->query(position(), width(), height()) : nullptr;
+    int candidate_count = candidates ? (int)candidates->size() : collidable_entity_count;
+
+    for (int i = 0; i < candidate_count; i++)
     {
-        Entity* collidable_entity = &collidable_entities[i];
+        Entity* collidable_entity = &collidable_entities[candidates ? (*candidates)[i] : i];
 
         if (check_collision(collidable_entity))
         {
-            float y_distance = fabs(m_position.y - collidable_entity->get_position().y);
-            float y_overlap = fabs(y_distance - (m_height / 2.0f) - (collidable_entity->get_height() / 2.0f));
-            if (m_velocity.y > 0) {
-                m_position.y -= y_overlap;
-                m_velocity.y = 0;
-                m_collided_top = true;
+            float y_distance = fabs(position().y - collidable_entity->get_position().y);
+            float y_overlap = fabs(y_distance - (height() / 2.0f) - (collidable_entity->get_height() / 2.0f));
+            if (velocity().y > 0) {
+                position().y -= y_overlap;
+                velocity().y = 0;
+                set_flag(FLAG_COLLIDED_TOP);
             }
-            else if (m_velocity.y < 0) {
-                m_position.y += y_overlap;
-                m_velocity.y = 0;
-                m_collided_bottom = true;
+            else if (velocity().y < 0) {
+                position().y += y_overlap;
+                velocity().y = 0;
+                set_flag(FLAG_COLLIDED_BOTTOM);
             }
         }
     }
@@ -146,58 +178,158 @@ void const Entity::check_collision_y(Entity* collidable_entities, int collidable
 */
 void const Entity::check_collision_y(Map* map)
 {
-    // Check all tiles above, including left and right for corner interaction
-    glm::vec3 top = glm::vec3(m_position.x, m_position.y + (m_height / 2), m_position.z);
-    glm::vec3 top_left = glm::vec3(m_position.x - (m_width / 2), m_position.y + (m_height / 2), m_position.z);
-    glm::vec3 top_right = glm::vec3(m_position.x + (m_width / 2), m_position.y + (m_height / 2), m_position.z);
-
-    // Check all tiles belove, including left and right for corner interaction
-    glm::vec3 bottom = glm::vec3(m_position.x, m_position.y - (m_height / 2), m_position.z);
-    glm::vec3 bottom_left = glm::vec3(m_position.x - (m_width / 2), m_position.y - (m_height / 2), m_position.z);
-    glm::vec3 bottom_right = glm::vec3(m_position.x + (m_width / 2), m_position.y - (m_height / 2), m_position.z);
-
-    float penetration_x = 0;
-    float penetration_y = 0;
+    PROFILE_SCOPE("Entity::check_collision_y map");
+    float x = position().x, half_width = width() / 2;
+    float y = position().y, half_height = height() / 2;
+
+    // Check all tiles above, then all tiles below, including left and right for corner interaction
+    // Padded to 8 points so the batch query fills whole SIMD lanes -- the last two are ignored
+    const int PROBES = 8;
+    float probe_x[PROBES] = { x, x - half_width, x + half_width, x, x - half_width, x + half_width, x, x };
+    float probe_y[PROBES] = { y + half_height, y + half_height, y + half_height,
+                              y - half_height, y - half_height, y - half_height, y, y };
+
+    bool  solid[PROBES];
+    float penetration_x[PROBES];
+    float penetration_y[PROBES];
+    map->is_solid_batch(probe_x, probe_y, PROBES, solid, penetration_x, penetration_y);
 
     // Logic if tiles are detected, stop all velocity and flag collision
-    if (map->is_solid(top, &penetration_x, &penetration_y) && m_velocity.y > 0)
+    // top, top left, top right -- first hit wins
+    for (int probe = 0; probe < 3; probe++)
     {
-        m_position.y -= penetration_y;
-        m_velocity.y = 0;
-        m_collided_top = true;
+        if (solid[probe] && velocity().y > 0)
+        {
+            position().y -= penetration_y[probe];
+            velocity().y = 0;
+            set_flag(FLAG_COLLIDED_TOP);
+            break;
+        }
     }
-    else if (map->is_solid(top_left, &penetration_x, &penetration_y) && m_velocity.y > 0)
+
+    // bottom, bottom left, bottom right -- first hit wins
+    for (int probe = 3; probe < 6; probe++)
     {
-        m_position.y -= penetration_y;
-        m_velocity.y = 0;
-        m_collided_top = true;
+        if (solid[probe] && velocity().y < 0)
+        {
+            position().y += penetration_y[probe];
+            velocity().y = 0;
+            set_flag(FLAG_COLLIDED_BOTTOM);
+            break;
+        }
     }
-    else if (map->is_solid(top_right, &penetration_x, &penetration_y) && m_velocity.y > 0)
+}
+
+/*
+* Sweeps this ENTITY's box along a move and stops it at the first solid tile
+* Keeps fast entities from tunnelling through one-tile platforms
+* A hit zeroes velocity on that axis and flags the side that was hit
+*
+* @param map, MAP object that the ENTITY object is moving through
+* @param displacement, the move this ENTITY wants to make this step
+*
+* @return how much of the move can be made, 0 to 1
+*/
+float Entity::sweep_map(Map* map, glm::vec3 displacement)
+{
+    PROFILE_SCOPE("Entity::sweep_map");
+    float time_of_impact = 1.0f;
+    glm::vec3 normal = glm::vec3(0.0f);
+
+    if (!map->sweep(position(), width(), height(), displacement, &time_of_impact, &normal)) return 1.0f;
+
+    if (normal.y > 0.0f)
     {
-        m_position.y -= penetration_y;
-        m_velocity.y = 0;
-        m_collided_top = true;
+        velocity().y = 0;
+        set_flag(FLAG_COLLIDED_BOTTOM);
     }
-
-    if (map->is_solid(bottom, &penetration_x, &penetration_y) && m_velocity.y < 0)
+    else if (normal.y < 0.0f)
     {
-        m_position.y += penetration_y;
-        m_velocity.y = 0;
-        m_collided_bottom = true;
+        velocity().y = 0;
+        set_flag(FLAG_COLLIDED_TOP);
     }
-    else if (map->is_solid(bottom_left, &penetration_x, &penetration_y) && m_velocity.y < 0)
+    else if (normal.x > 0.0f)
     {
-        m_position.y += penetration_y;
-        m_velocity.y = 0;
-        m_collided_bottom = true;
+        velocity().x = 0;
+        set_flag(FLAG_COLLIDED_LEFT);
     }
-    else if (map->is_solid(bottom_right, &penetration_x, &penetration_y) && m_velocity.y < 0)
+    else
     {
-        m_position.y += penetration_y;
-        m_velocity.y = 0;
-        m_collided_bottom = true;
-
+        velocity().x = 0;
+        set_flag(FLAG_COLLIDED_RIGHT);
     }
+
+    return time_of_impact;
+}
+
+/*
+* Copies this ENTITY's STORE slot and own fields into a snapshot
+*
+* @param snapshot, receives the copy
+*/
+void Entity::save_snapshot(EntitySnapshot& snapshot) const
+{
+    snapshot.position = position();
+    snapshot.velocity = velocity();
+    snapshot.acceleration = acceleration();
+    snapshot.movement = movement();
+    snapshot.speed = current_speed();
+    snapshot.width = width();
+    snapshot.height = height();
+    snapshot.flags = m_store->flags[m_index];
+
+    snapshot.walk_speed = m_walk_speed;
+    snapshot.sprint_speed = m_sprint_speed;
+    snapshot.sneak_speed = m_sneak_speed;
+    snapshot.jumping_power = m_jumping_power;
+    snapshot.continuous_collision = m_continuous_collision;
+    snapshot.spawn_position = m_spawn_position;
+
+    snapshot.entity_type = m_entity_type;
+    snapshot.movement_state = movement_state;
+    snapshot.ai_type = m_ai_type;
+    snapshot.ai_state = m_ai_state;
+
+    snapshot.is_facing_right = is_facing_right;
+    snapshot.is_dead = is_dead;
+    snapshot.is_jumping = m_is_jumping;
+    snapshot.ability_timer = ability_timer;
+    snapshot.ability_cooldown = ability_cooldown;
+}
+
+/*
+* Puts this ENTITY back the way save_snapshot found it -- same STORE slot
+*
+* @param snapshot, the copy to restore
+*/
+void Entity::load_snapshot(const EntitySnapshot& snapshot)
+{
+    position() = snapshot.position;
+    velocity() = snapshot.velocity;
+    acceleration() = snapshot.acceleration;
+    movement() = snapshot.movement;
+    current_speed() = snapshot.speed;
+    width() = snapshot.width;
+    height() = snapshot.height;
+    m_store->flags[m_index] = snapshot.flags;
+
+    m_walk_speed = snapshot.walk_speed;
+    m_sprint_speed = snapshot.sprint_speed;
+    m_sneak_speed = snapshot.sneak_speed;
+    m_jumping_power = snapshot.jumping_power;
+    m_continuous_collision = snapshot.continuous_collision;
+    m_spawn_position = snapshot.spawn_position;
+
+    m_entity_type = snapshot.entity_type;
+    movement_state = snapshot.movement_state;
+    m_ai_type = snapshot.ai_type;
+    m_ai_state = snapshot.ai_state;
+
+    is_facing_right = snapshot.is_facing_right;
+    is_dead = snapshot.is_dead;
+    m_is_jumping = snapshot.is_jumping;
+    ability_timer = snapshot.ability_timer;
+    ability_cooldown = snapshot.ability_cooldown;
 }
 
 /*
@@ -207,38 +339,46 @@ void const Entity::check_collision_y(Map* map)
 *
 * @param collidable_entities, an array of all entities that this ENTITY can collide with
 * @param collidable_entity_count, size of the array above
+* @param grid, optional broadphase built from collidable_entities -- skips far away ones
 * 
 * TREAT LIKE ON_COLLISION_ENTER
 */
-void const Entity::check_collision_x(Entity* collidable_entities, int collidable_entity_count)
+void const Entity::check_collision_x(Entity* collidable_entities, int collidable_entity_count, SpatialGrid* grid)
 {
-    for (int i = 0; i < collidable_entity_count; i++)
+    PROFILE_SCOPE("Entity::check_collision_x entities");
+    // candidates come back in ascending order, the same order the full loop visits them in --
+    // but the grid is queried once, at the starting position, so an entity only
+    // pushed into reach by an earlier overlap isn't tested
+    const std::vector<int>* candidates = grid ? &grid->query(position(), width(), height()) : nullptr;
+    int candidate_count = candidates ? (int)candidates->size() : collidable_entity_count;
+
+    for (int i = 0; i < candidate_count; i++)
     {
-        Entity* collidable_entity = &collidable_entities[i];
+        Entity* collidable_entity = &collidable_entities[candidates ? (*candidates)[i] : i];
 
         if (check_collision(collidable_entity))
         {
             if (collidable_entity->get_entity_type() == PLAYER && m_entity_type == ENEMY)
             {
                 collidable_entity->is_dead = true;
-                collidable_entity->m_is_active = false;
+                collidable_entity->deactivate();
             }
             if (collidable_entity->get_entity_type() == ENEMY && m_entity_type == WEAPON)
             {
                 collidable_entity->is_dead = true;
-                collidable_entity->m_is_active = false;
+                collidable_entity->deactivate();
             }
-            float x_distance = fabs(m_position.x - collidable_entity->get_position().x);
-            float x_overlap = fabs(x_distance - (m_width / 2.0f) - (collidable_entity->get_width() / 2.0f));
-            if (m_velocity.x > 0) {
-                m_position.x -= x_overlap;
-                m_velocity.x = 0;
-                m_collided_right = true;
+            float x_distance = fabs(position().x - collidable_entity->get_position().x);
+            float x_overlap = fabs(x_distance - (width() / 2.0f) - (collidable_entity->get_width() / 2.0f));
+            if (velocity().x > 0) {
+                position().x -= x_overlap;
+                velocity().x = 0;
+                set_flag(FLAG_COLLIDED_RIGHT);
             }
-            else if (m_velocity.x < 0) {
-                m_position.x += x_overlap;
-                m_velocity.x = 0;
-                m_collided_left = true;
+            else if (velocity().x < 0) {
+                position().x += x_overlap;
+                velocity().x = 0;
+                set_flag(FLAG_COLLIDED_LEFT);
             }
         }
     }
@@ -251,55 +391,28 @@ void const Entity::check_collision_x(Entity* collidable_entities, int collidable
 */
 void const Entity::check_collision_x(Map* map)
 {
+    PROFILE_SCOPE("Entity::check_collision_x map");
     // Check if touching tile
-    glm::vec3 left = glm::vec3(m_position.x - (m_width / 2), m_position.y, m_position.z);
-    glm::vec3 right = glm::vec3(m_position.x + (m_width / 2), m_position.y, m_position.z);
+    glm::vec3 left = glm::vec3(position().x - (width() / 2), position().y, position().z);
+    glm::vec3 right = glm::vec3(position().x + (width() / 2), position().y, position().z);
 
     float penetration_x = 0;
     float penetration_y = 0;
 
-    if (map->is_solid(left, &penetration_x, &penetration_y) && m_velocity.x < 0)
+    if (map->is_solid(left, &penetration_x, &penetration_y) && velocity().x < 0)
     {
-        m_position.x += penetration_x;
-        m_velocity.x = 0;
-        m_collided_left = true;
+        position().x += penetration_x;
+        velocity().x = 0;
+        set_flag(FLAG_COLLIDED_LEFT);
     }
-    if (map->is_solid(right, &penetration_x, &penetration_y) && m_velocity.x > 0)
+    if (map->is_solid(right, &penetration_x, &penetration_y) && velocity().x > 0)
     {
-        m_position.x -= penetration_x;
-        m_velocity.x = 0;
-        m_collided_right = true;
+        position().x -= penetration_x;
+        velocity().x = 0;
+        set_flag(FLAG_COLLIDED_RIGHT);
     }
 }
 
-/*
-* Render function specifically for the ENTITY class
-* 
-* @param program, reference to the SHADERPROGRAM class -- to use it's functions
-*/
-void Entity::render(ShaderProgram* program)
-{
-    program->set_model_matrix(m_model_matrix);
-
-    // if not active -- then can't render, treat like deletion
-    if (!m_is_active) { return; }
-
-    float vertices[] = { -0.5, -0.5, 0.5, -0.5, 0.5, 0.5, -0.5, -0.5, 0.5, 0.5, -0.5, 0.5 };
-    float tex_coords[] = { 0.0,  1.0, 1.0,  1.0, 1.0, 0.0,  0.0,  1.0, 1.0, 0.0,  0.0, 0.0 };
-
-    glBindTexture(GL_TEXTURE_2D, m_texture_id);
-
-    glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, 0, vertices);
-    glEnableVertexAttribArray(program->get_position_attribute());
-    glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, 0, tex_coords);
-    glEnableVertexAttribArray(program->get_tex_coordinate_attribute());
-
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-
-    glDisableVertexAttribArray(program->get_position_attribute());
-    glDisableVertexAttribArray(program->get_tex_coordinate_attribute());
-}
-
 /*
 * General check collision function for static object
 * 
@@ -311,10 +424,10 @@ bool const Entity::check_collision(Entity* other) const
 {
     if (other == this) return false;
     // If either entity is inactive, there shouldn't be any collision
-    if (!m_is_active || !other->m_is_active) return false;
+    if (!is_active() || !other->is_active()) return false;
 
-    float x_distance = fabs(m_position.x - other->m_position.x) - ((m_width + other->m_width) / 2.0f);
-    float y_distance = fabs(m_position.y - other->m_position.y) - ((m_height + other->m_height) / 2.0f);
+    float x_distance = fabs(position().x - other->position().x) - ((width() + other->width()) / 2.0f);
+    float y_distance = fabs(position().y - other->position().y) - ((height() + other->height()) / 2.0f);
 
     return x_distance < 0.0f && y_distance < 0.0f;
 }
@@ -331,6 +444,7 @@ bool const Entity::check_collision(Entity* other) const
 */
 void Entity::ai_activate(Entity* player, float delta_time)
 {
+    PROFILE_SCOPE("Entity::ai_activate");
     switch (m_ai_type)
     {
     case FREDDY:
@@ -365,6 +479,7 @@ void Entity::ai_activate(Entity* player, float delta_time)
 */
 void Entity::ai_patrol(Entity* player, float delta_time)
 {
+    PROFILE_SCOPE("Entity::ai_patrol");
     switch (m_ai_state)
     {
     case IDLE:
@@ -373,25 +488,25 @@ void Entity::ai_patrol(Entity* player, float delta_time)
 
     case PATROLING:
         movement_state = WALK;
-        current_speed = m_walk_speed;
+        current_speed() = m_walk_speed;
         if (is_facing_right)
         {
-            m_movement = glm::vec3(1.0f, 0.0f, 0.0f);
+            movement() = glm::vec3(1.0f, 0.0f, 0.0f);
         }
         else
         {
-            m_movement = glm::vec3(-1.0f, 0.0f, 0.0f);
+            movement() = glm::vec3(-1.0f, 0.0f, 0.0f);
         }
 
         ability_timer -= delta_time;
         if (ability_timer <= 0.0f)
         {
-            ability_timer = 2.0f;
+            ability_timer = ability_cooldown;
             is_facing_right = !is_facing_right;
         }
 
-        if ((glm::abs(m_position.x - player->get_position().x) < 0.25f) 
-            && (m_position.y == player->get_position().y) &&
+        if ((glm::abs(position().x - player->get_position().x) < 0.25f) 
+            && (position().y == player->get_position().y) &&
             is_facing_right == player->is_facing_right)
         {
             m_ai_state = CHASING;
@@ -399,14 +514,14 @@ void Entity::ai_patrol(Entity* player, float delta_time)
 
     case CHASING:
         movement_state = SPRINT;
-        current_speed = m_sprint_speed;
+        current_speed() = m_sprint_speed;
         if (is_facing_right)
         {
-            m_movement = glm::vec3(1.0f, 0.0f, 0.0f);
+            movement() = glm::vec3(1.0f, 0.0f, 0.0f);
         }
         else
         {
-            m_movement = glm::vec3(-1.0f, 0.0f, 0.0f);
+            movement() = glm::vec3(-1.0f, 0.0f, 0.0f);
         }
     }
 }
@@ -421,11 +536,12 @@ void Entity::ai_patrol(Entity* player, float delta_time)
 */
 void Entity::ai_stealth_activate(Entity* player)
 {
+    PROFILE_SCOPE("Entity::ai_stealth_activate");
     switch (m_ai_state)
     {
     case IDLE: 
-        if ((glm::abs(m_position.x - player->get_position().x) < 2.0f)
-            && (m_position.y == player->get_position().y))
+        if ((glm::abs(position().x - player->get_position().x) < 2.0f)
+            && (position().y == player->get_position().y))
         {
             if (player->get_player_state() == SNEAK) break;
             else m_ai_state = CHASING;
@@ -434,12 +550,12 @@ void Entity::ai_stealth_activate(Entity* player)
 
     case CHASING:
         movement_state = SPRINT;
-        current_speed = m_sprint_speed;
-        if (m_position.x > player->get_position().x) {
-            m_movement = glm::vec3(-1.0f, 0.0f, 0.0f);
+        current_speed() = m_sprint_speed;
+        if (position().x > player->get_position().x) {
+            movement() = glm::vec3(-1.0f, 0.0f, 0.0f);
         }
         else {
-            m_movement = glm::vec3(1.0f, 0.0f, 0.0f);
+            movement() = glm::vec3(1.0f, 0.0f, 0.0f);
         }
         break;
     }    
@@ -454,17 +570,18 @@ void Entity::ai_stealth_activate(Entity* player)
 */
 void Entity::ai_peekaboo(Entity* player)
 {
+    PROFILE_SCOPE("Entity::ai_peekaboo");
     switch (m_ai_state)
     {
     case IDLE: 
-        m_movement = glm::vec3(0.0f, 0.0f, 0.0f);
+        movement() = glm::vec3(0.0f, 0.0f, 0.0f);
         if (player->is_facing_right == false) m_ai_state = CHASING;
         break;
 
     case CHASING:
         movement_state = SPRINT;
-        current_speed = m_sprint_speed;
-        m_movement = glm::vec3(-1.0f, 0.0f, 0.0f);
+        current_speed() = m_sprint_speed;
+        movement() = glm::vec3(-1.0f, 0.0f, 0.0f);
         if (player->is_facing_right == true) m_ai_state = IDLE;
         break;
     }
@@ -474,13 +591,15 @@ void Entity::ai_peekaboo(Entity* player)
 * Used by the Freddy enemy
 * Immediately go into the patroling state
 * When patroling, start a countdown
-* When the countdown is over teleport randomly to one of the set locations
+* When the countdown is over teleport randomly to one of the set locations,
+* measured from where this ENEMY spawned
 * Restart countdown
 * Inspired by Freddy's movement in the original FNAF
 */
 void Entity::ai_teleport(Entity* player, float delta_time)
 {
-    std::vector<glm::vec3> positions =
+    PROFILE_SCOPE("Entity::ai_teleport");
+    static const glm::vec3 positions[] =
     { glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(7.75f, 0.0f, 0.0f), glm::vec3(12.0f, 0.0f, 0.0f) };
 
     switch (m_ai_state)
@@ -492,10 +611,9 @@ void Entity::ai_teleport(Entity* player, float delta_time)
         ability_timer -= delta_time;
         if (ability_timer <= 0.0f)
         {
-            int random_position = rand() % 3;
-            set_position(positions[random_position]);
-            std::cout << get_position().x << std::endl;
-            ability_timer = 2.0f;
+            int random_position = m_store->random.range(3); // per-world stream, not rand()
+            set_position(m_spawn_position + positions[random_position]);
+            ability_timer = ability_cooldown;
         }
     default:
         break;
@@ -1,67 +1,102 @@
+#pragma once
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
 enum EntityType { PLAYER, PLATFORM, ENEMY, WEAPON };
 enum AIState { IDLE, PATROLING, CHASING };
 enum AIType { FREDDY, BONNIE, CHICA, FOXY };
 enum PlayerState { WALK, SPRINT, SNEAK };
 
-#include "Map.h";
+#include "Map.h"
+#include "EntityStore.h"
+#include "SpatialGrid.h"
+#include "SpriteRegion.h"
+
+class ShaderProgram;
+class SpriteBatch;
+class InstancedSprites;
+struct EntitySnapshot;
 
 class Entity {
 private:
-    // position and tranformation variables
-    glm::vec3 m_position;
-    glm::mat4 m_model_matrix;
-
-    // physics variables
-    glm::vec3 m_velocity;
-    glm::vec3 m_acceleration;
-    glm::vec3 m_movement;
+    // position, physics and collision flags live in the STORE -- this ENTITY is a view onto slot m_index
+    EntityStore* m_store = nullptr;
+    int          m_index = -1;
+
+    glm::vec3& position()     const { return m_store->positions[m_index]; }
+    glm::vec3& velocity()     const { return m_store->velocities[m_index]; }
+    glm::vec3& acceleration() const { return m_store->accelerations[m_index]; }
+    glm::vec3& movement()     const { return m_store->movements[m_index]; }
+    float&     current_speed() const { return m_store->speeds[m_index]; }
+    float&     width()        const { return m_store->widths[m_index]; }
+    float&     height()       const { return m_store->heights[m_index]; }
+
+    bool has_flag(uint8_t flag) const { return (m_store->flags[m_index] & flag) != 0; }
+    void set_flag(uint8_t flag) { m_store->flags[m_index] |= flag; }
+    void clear_flag(uint8_t flag) { m_store->flags[m_index] &= ~flag; }
 
     // specific to different entity types
-    float m_walk_speed;
-    float m_sprint_speed;
-    float m_sneak_speed;
-    float current_speed;
+    float m_walk_speed = 0.0f;
+    float m_sprint_speed = 0.0f;
+    float m_sneak_speed = 0.0f;
     float m_jumping_power = 8.0f;
-    float m_width = 1;
-    float m_height = 1;
 
-    EntityType m_entity_type; // type of entity - treat as NAME
+    // sweep against the MAP instead of only point sampling -- for fast movers
+    // steps longer than a tile sweep anyway, see finish_update
+    bool m_continuous_collision = false;
 
-    bool m_is_active = true;
+    EntityType m_entity_type = PLATFORM; // type of entity - treat as NAME
 
     // PLAYER MOVEMENT STATE
-    PlayerState movement_state;
+    PlayerState movement_state = WALK;
 
     // ENEMY AI
-    AIType     m_ai_type;
-    AIState    m_ai_state;
+    AIType     m_ai_type = FREDDY;
+    AIState    m_ai_state = IDLE;
+    glm::vec3  m_spawn_position = glm::vec3(0.0f); // FREDDY's teleport spots are measured from here
 
 public:
-    GLuint m_texture_id; // texture
-
-    // physics - collision for all directions
-    bool m_collided_top = false;
-    bool m_collided_bottom = false;
-    bool m_collided_left = false;
-    bool m_collided_right = false;
+    SpriteRegion m_sprite; // atlas page and rectangle -- only used by the renderer
 
     bool is_facing_right = true;
     bool is_dead = false;
     float ability_timer = 2.0f;
+    float ability_cooldown = 2.0f; // what ability_timer resets to
     bool m_is_jumping = false;
 
-    // default constructor
+    // default constructor -- a view onto nothing until attach() is called
     Entity();
 
-    void update(float delta_time, Entity* player, Entity* objects, int object_count, Map* map);
-    void render(ShaderProgram* program);
+    // takes a fresh slot in the STORE
+    void attach(EntityStore* store);
+
+    void update(float delta_time, Entity* player, Entity* objects, int object_count, Map* map,
+        SpatialGrid* grid = nullptr);
+    void render(ShaderProgram* program); // defined in EntityRender.cpp
+    void draw(SpriteBatch& batch) const; // queues this ENTITY's sprite -- also in EntityRender.cpp
+    void draw(InstancedSprites& sprites) const; // same, for the instanced path
+
+    // update() split in two so the velocity step can run over the STORE in one loop
+    // begin_update -> EntityStore::integrate_velocities -> finish_update
+    void begin_update(float delta_time, Entity* player);
+    void finish_update(float delta_time, Entity* objects, int object_count, Map* map,
+        SpatialGrid* grid = nullptr);
 
     // collisions - both in the x and y axis
+    // grid, when given, must have been built from collidable_entities this tick
     bool const check_collision(Entity* other) const;
-    void const check_collision_y(Entity* collidable_entities, int collidable_entity_count);
+    void const check_collision_y(Entity* collidable_entities, int collidable_entity_count, SpatialGrid* grid = nullptr);
     void const check_collision_y(Map* map);
-    void const check_collision_x(Entity* collidable_entities, int collidable_entity_count);
+    void const check_collision_x(Entity* collidable_entities, int collidable_entity_count, SpatialGrid* grid = nullptr);
     void const check_collision_x(Map* map);
+    float sweep_map(Map* map, glm::vec3 displacement);
+
+    // copies everything but the texture to/from a plain snapshot -- see Snapshot.h
+    void save_snapshot(EntitySnapshot& snapshot) const;
+    void load_snapshot(const EntitySnapshot& snapshot);
 
     // ai scripts -- also located at bottom of .cpp file
     void ai_activate(Entity* player, float delta_time);
@@ -70,40 +105,54 @@ public:
     void ai_stealth_activate(Entity* player); // chica
     void ai_peekaboo(Entity* player); // foxy
 
-    void activate() { m_is_active = true; };
-    void deactivate() { m_is_active = false; };
+    void activate() { set_flag(FLAG_ACTIVE); };
+    void deactivate() { clear_flag(FLAG_ACTIVE); };
 
     // movement
-    void move_left() { m_movement.x = -1.0f; }
-    void move_right() { m_movement.x = 1.0f; }
+    void move_left() { movement().x = -1.0f; }
+    void move_right() { movement().x = 1.0f; }
 
     // GETTERS
     EntityType const get_entity_type()    const { return m_entity_type; };
-    glm::vec3  const get_position()       const { return m_position; };
-    glm::vec3  const get_movement()       const { return m_movement; };
-    glm::vec3  const get_velocity()       const { return m_velocity; };
-    glm::vec3  const get_acceleration()   const { return m_acceleration; };
-    int        const get_width()          const { return m_width; };
-    int        const get_height()         const { return m_height; };
+    glm::vec3  const get_position()       const { return position(); };
+    glm::vec3  const get_movement()       const { return movement(); };
+    glm::vec3  const get_velocity()       const { return velocity(); };
+    glm::vec3  const get_acceleration()   const { return acceleration(); };
+    float      const get_width()          const { return width(); };
+    float      const get_height()         const { return height(); };
     PlayerState const get_player_state() const { return movement_state; }
     AIType     const get_ai_type()        const { return m_ai_type; };
     AIState    const get_ai_state()       const { return m_ai_state; };
+    bool       const is_active()          const { return has_flag(FLAG_ACTIVE); };
+    bool       const get_collided_top()    const { return has_flag(FLAG_COLLIDED_TOP); };
+    bool       const get_collided_bottom() const { return has_flag(FLAG_COLLIDED_BOTTOM); };
+    bool       const get_collided_left()   const { return has_flag(FLAG_COLLIDED_LEFT); };
+    bool       const get_collided_right()  const { return has_flag(FLAG_COLLIDED_RIGHT); };
+    int        const get_index()          const { return m_index; };
+    bool       const get_continuous_collision() const { return m_continuous_collision; };
+    float      const get_walk_speed()     const { return m_walk_speed; };
+    float      const get_sprint_speed()   const { return m_sprint_speed; };
+    float      const get_sneak_speed()    const { return m_sneak_speed; };
+    float      const get_jumping_power()  const { return m_jumping_power; };
+    glm::vec3  const get_spawn_position() const { return m_spawn_position; };
 
     // SETTLERS
     void const set_entity_type(EntityType new_entity_type) { m_entity_type = new_entity_type; };
-    void const set_position(glm::vec3 new_position) { m_position = new_position; };
-    void const set_movement(glm::vec3 new_movement) { m_movement = new_movement; };
-    void const set_velocity(glm::vec3 new_velocity) { m_velocity = new_velocity; };
+    void const set_position(glm::vec3 new_position) { position() = new_position; };
+    void const set_movement(glm::vec3 new_movement) { movement() = new_movement; };
+    void const set_velocity(glm::vec3 new_velocity) { velocity() = new_velocity; };
     void const set_speeds(float new_walk, float new_sprint, float new_sneak)
     {
         m_walk_speed = new_walk;
         m_sprint_speed = new_sprint;
         m_sneak_speed = new_sneak;
     }
-    void const set_acceleration(glm::vec3 new_acceleration) { m_acceleration = new_acceleration; };
-    void const set_width(float new_width) { m_width = new_width; };
-    void const set_height(float new_height) { m_height = new_height; };
+    void const set_acceleration(glm::vec3 new_acceleration) { acceleration() = new_acceleration; };
+    void const set_width(float new_width) { width() = new_width; };
+    void const set_height(float new_height) { height() = new_height; };
     void const set_movement_state(PlayerState new_player_state) { movement_state = new_player_state; };
     void const set_ai_type(AIType new_ai_type) { m_ai_type = new_ai_type; };
     void const set_ai_state(AIState new_state) { m_ai_state = new_state; };
+    void const set_spawn_position(glm::vec3 new_spawn_position) { m_spawn_position = new_spawn_position; };
+    void const set_continuous_collision(bool enabled) { m_continuous_collision = enabled; };
 };
\ No newline at end of file
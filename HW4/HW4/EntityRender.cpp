@@ -0,0 +1,88 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "ShaderProgram.h"
+#include "SpriteBatch.h"
+#include "InstancedSprites.h"
+#include "RenderState.h"
+#include "Entity.h"
+
+/*
+* Render function specifically for the ENTITY class
+* 
+* @param program, reference to the SHADERPROGRAM class -- to use it's functions
+*/
+void Entity::render(ShaderProgram* program)
+{
+    // model matrix is rebuilt here instead of stored -- update only touches the STORE
+    glm::mat4 model_matrix = glm::translate(glm::mat4(1.0f), position());
+    g_render_state.use_program(program->get_program_id());
+    program->set_model_matrix(model_matrix);
+
+    // if not active -- then can't render, treat like deletion
+    if (!is_active()) { return; }
+
+    float vertices[] = { -0.5, -0.5, 0.5, -0.5, 0.5, 0.5, -0.5, -0.5, 0.5, 0.5, -0.5, 0.5 };
+    float tex_coords[] = { 0.0,  1.0, 1.0,  1.0, 1.0, 0.0,  0.0,  1.0, 1.0, 0.0,  0.0, 0.0 };
+
+    // into the sprite's rectangle on its atlas page
+    for (int i = 0; i < 12; i += 2)
+    {
+        tex_coords[i] = m_sprite.rect.x + tex_coords[i] * m_sprite.rect.z;
+        tex_coords[i + 1] = m_sprite.rect.y + tex_coords[i + 1] * m_sprite.rect.w;
+    }
+
+    g_render_state.bind_texture(m_sprite.texture_id);
+
+    glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, 0, vertices);
+    g_render_state.enable_attribute(program->get_position_attribute());
+    glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, 0, tex_coords);
+    g_render_state.enable_attribute(program->get_tex_coordinate_attribute());
+
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+/*
+* Batched version of render -- adds this ENTITY's quad to the frame's SPRITEBATCH
+* 
+* @param batch, the SPRITEBATCH being filled this frame
+*/
+void Entity::draw(SpriteBatch& batch) const
+{
+    // if not active -- then can't render, treat like deletion
+    if (!is_active()) { return; }
+
+    batch.draw(m_sprite.texture_id, position(), 1.0f, 1.0f, m_sprite.rect);
+}
+
+/*
+* Instanced version of render -- adds this ENTITY to the frame's INSTANCEDSPRITES
+* 
+* @param sprites, the INSTANCEDSPRITES being filled this frame
+*/
+void Entity::draw(InstancedSprites& sprites) const
+{
+    // if not active -- then can't render, treat like deletion
+    if (!is_active()) { return; }
+
+    // mirrored when facing left -- only this path flips, render and the SPRITEBATCH draw as the sheet is
+    sprites.draw(m_sprite.texture_id, position(), 1.0f, 1.0f, m_sprite.rect, !is_facing_right);
+}
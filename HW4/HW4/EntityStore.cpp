@@ -0,0 +1,103 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include "EntityStore.h"
+
+/*
+* Appends a new slot with the same defaults the ENTITY constructor used
+*
+* @return the index of the new slot
+*/
+int EntityStore::create()
+{
+	positions.push_back(glm::vec3(0.0f));
+	velocities.push_back(glm::vec3(0.0f));
+	accelerations.push_back(glm::vec3(0.0f));
+	movements.push_back(glm::vec3(0.0f));
+
+	speeds.push_back(0.0f);
+	widths.push_back(1.0f);
+	heights.push_back(1.0f);
+
+	flags.push_back(FLAG_ACTIVE);
+
+	return size() - 1;
+}
+
+size_t EntityStore::get_bytes() const
+{
+	return (positions.capacity() + velocities.capacity() + accelerations.capacity() + movements.capacity()) * sizeof(glm::vec3)
+		+ (speeds.capacity() + widths.capacity() + heights.capacity()) * sizeof(float)
+		+ flags.capacity() * sizeof(uint8_t);
+}
+
+/*
+* Reserves room for capacity slots in every array
+*
+* @param capacity, total number of entities expected
+*/
+void EntityStore::reserve(int capacity)
+{
+	positions.reserve(capacity);
+	velocities.reserve(capacity);
+	accelerations.reserve(capacity);
+	movements.reserve(capacity);
+
+	speeds.reserve(capacity);
+	widths.reserve(capacity);
+	heights.reserve(capacity);
+
+	flags.reserve(capacity);
+}
+
+/*
+* Drops every slot -- views onto this store are invalid afterwards
+*/
+void EntityStore::clear()
+{
+	positions.clear();
+	velocities.clear();
+	accelerations.clear();
+	movements.clear();
+
+	speeds.clear();
+	widths.clear();
+	heights.clear();
+
+	flags.clear();
+}
+
+/*
+* The velocity half of ENTITY::update for a contiguous range of slots
+* Clears last tick's collision flags and applies movement and acceleration
+* Inactive slots are skipped, same as ENTITY::update
+*
+* @param first, index of the first slot
+* @param count, number of slots to integrate
+* @param delta_time, fixed time step in seconds
+*/
+void EntityStore::integrate_velocities(int first, int count, float delta_time)
+{
+	glm::vec3* velocity = velocities.data() + first;
+	const glm::vec3* acceleration = accelerations.data() + first;
+	const glm::vec3* movement = movements.data() + first;
+	const float* speed = speeds.data() + first;
+	uint8_t* flag = flags.data() + first;
+
+	for (int i = 0; i < count; i++)
+	{
+		if (!(flag[i] & FLAG_ACTIVE)) continue;
+
+		flag[i] &= ~FLAG_COLLIDED_ANY;
+
+		velocity[i].x = movement[i].x * speed[i];
+		velocity[i] += acceleration[i] * delta_time; // velocity equation implemented in code
+	}
+}
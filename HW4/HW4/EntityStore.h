@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include "glm/vec3.hpp"
+#include "Random.h"
+
+// bits packed into EntityStore::flags
+enum EntityFlag : uint8_t
+{
+	FLAG_ACTIVE = 1 << 0,
+	FLAG_COLLIDED_TOP = 1 << 1,
+	FLAG_COLLIDED_BOTTOM = 1 << 2,
+	FLAG_COLLIDED_LEFT = 1 << 3,
+	FLAG_COLLIDED_RIGHT = 1 << 4,
+
+	FLAG_COLLIDED_ANY = FLAG_COLLIDED_TOP | FLAG_COLLIDED_BOTTOM | FLAG_COLLIDED_LEFT | FLAG_COLLIDED_RIGHT
+};
+
+/*
+* Structure-of-arrays storage for the per-tick physics data of every ENTITY
+* Each ENTITY is a view onto one slot (index) of these arrays, so the
+* integration step can run as a flat loop instead of hopping between objects
+*/
+struct EntityStore
+{
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec3> velocities;
+	std::vector<glm::vec3> accelerations;
+	std::vector<glm::vec3> movements;
+
+	std::vector<float> speeds; // current speed, picked from the movement state
+	std::vector<float> widths;
+	std::vector<float> heights;
+
+	std::vector<uint8_t> flags;
+
+	// the world's random stream -- every ENTITY of a world shares its STORE, so AI draws from here
+	Random random;
+
+	int  create();
+	int  size() const { return (int)positions.size(); }
+	void reserve(int capacity);
+	void clear();
+	size_t get_bytes() const; // every array's allocation
+
+	void integrate_velocities(int first, int count, float delta_time);
+};
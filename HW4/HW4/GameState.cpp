@@ -0,0 +1,364 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include "GameState.h"
+#include "Profiler.h"
+#include "InputLog.h"
+#include "LevelGenerator.h"
+
+unsigned int LEVEL_1_DATA[] =
+{
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	1, 1, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 1, 1,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	3, 3, 3, 3, 3, 3, 3, 3, 2, 2, 2, 2, 2, 2
+};
+
+/*
+* Initialises an ENEMY ENTITY object
+*
+* @param enemy, the ENEMY ENTITY object
+* @param AITYPE, what animatronic they are
+* @param position, the position the enemy is going to spawn at
+*/
+static void init_enemy(Entity& enemy, AIType animatronic, glm::vec3 position)
+{
+	enemy.set_entity_type(ENEMY);
+	enemy.set_ai_type(animatronic);
+	enemy.set_position(position);
+	enemy.set_spawn_position(position);
+	enemy.set_movement(glm::vec3(0.0f));
+	enemy.set_speeds(.50f, 2.0f, 0.25f);
+	enemy.set_acceleration(glm::vec3(0.0f, -9.81f, 0.0f));
+	enemy.set_ai_state(IDLE);
+}
+
+/*
+* Sets up the player and both weapon slots -- after the enemies, so those
+* stay one contiguous range of the STORE
+*
+* @param state, the GAMESTATE being initialised
+* @param position, where the player spawns
+*/
+static void init_player_and_weapons(GameState& state, glm::vec3 position)
+{
+	// PLAYER
+	state.player = new Entity();
+	state.player->attach(state.store);
+	state.player->set_entity_type(PLAYER);
+	state.player->set_position(position);
+	state.player->set_movement(glm::vec3(0.0f, 0.0f, 0.0f));
+	state.player->set_speeds(1.5f, 4.0f, 0.5f);
+	state.player->set_acceleration(glm::vec3(0.0f, -9.81f, 0.0f)); // gravity
+	state.player->set_continuous_collision(true); // sprinting and falling can outrun a one-tile platform
+	state.player->is_facing_right = true;
+
+	// WEAPON
+	state.weapons = new Entity[2];
+	for (size_t i = 0; i < 2; ++i) state.weapons[i].attach(state.store);
+	state.trap_placed = false;
+	state.tick = 0;
+}
+
+/*
+* Sets up the map, enemies, player and weapons for level 1
+* Entities are left without textures -- the renderer assigns those
+*
+* @param state, the GAMESTATE to fill in
+* @param map_texture_id, the tile set texture (0 when running headless)
+* @param seed, seeds this world's random stream
+*/
+void initialise_game_state(GameState& state, unsigned int map_texture_id, uint64_t seed)
+{
+	PROFILE_SCOPE("initialise_game_state");
+	// MAP
+	state.map = new Map(LEVEL1_WIDTH, LEVEL1_HEIGHT, LEVEL_1_DATA, map_texture_id, 1.0f, 3, 1);
+
+	// STORE -- enemies are attached first so they sit in one contiguous range
+	state.store = new EntityStore();
+	state.store->reserve(ENEMY_COUNT + 3);
+	state.store->random.seed(seed);
+
+	// ENEMIES -- order matters, the renderer matches textures to these slots
+	state.enemy_count = ENEMY_COUNT;
+	state.enemies = new Entity[ENEMY_COUNT];
+	for (size_t i = 0; i < ENEMY_COUNT; ++i) state.enemies[i].attach(state.store);
+	init_enemy(state.enemies[0], BONNIE, glm::vec3(7.75f, 0.0f, 0.0f));
+	init_enemy(state.enemies[1], CHICA, glm::vec3(7.75f, -2.75f, 0.0f));
+	init_enemy(state.enemies[2], FOXY, glm::vec3(12.0f, -2.75f, 0.0f));
+	init_enemy(state.enemies[3], FREDDY, glm::vec3(0.0f, 0.0f, 0.0f));
+
+	init_player_and_weapons(state, glm::vec3(3.0f, -3.0f, 0.0f));
+}
+
+/*
+* Sets up a level from generate_level -- as big as it was generated, with
+* every enemy it placed
+* Entities are left without textures, same as level 1
+*
+* @param state, the GAMESTATE to fill in
+* @param level, a GENERATEDLEVEL -- its tiles are moved into the MAP, so it's left without them
+* @param map_texture_id, the tile set texture (0 when running headless)
+* @param seed, seeds this world's random stream
+*/
+void initialise_generated_state(GameState& state, GeneratedLevel& level, unsigned int map_texture_id, uint64_t seed)
+{
+	PROFILE_SCOPE("initialise_generated_state");
+	// MAP
+	state.map = new Map(level.width, level.height, std::move(level.tiles), map_texture_id, GENERATED_TILE_SIZE, 3, 1);
+
+	// STORE -- enemies are attached first so they sit in one contiguous range
+	state.enemy_count = (int)level.enemies.size();
+	state.store = new EntityStore();
+	state.store->reserve(state.enemy_count + 3);
+	state.store->random.seed(seed);
+
+	// ENEMIES
+	state.enemies = new Entity[state.enemy_count];
+	for (int i = 0; i < state.enemy_count; ++i)
+	{
+		state.enemies[i].attach(state.store);
+		init_enemy(state.enemies[i], level.enemies[i].ai_type, level.enemies[i].position);
+	}
+
+	init_player_and_weapons(state, level.player_spawn);
+}
+
+/*
+* Places the trap in front of the player
+* The first call also turns the trap into a WEAPON entity
+*
+* @param state, the current GAMESTATE
+*/
+void place_trap(GameState& state)
+{
+	if (!state.trap_placed)
+	{
+		state.trap_placed = true;
+		state.weapons[0].set_entity_type(WEAPON);
+		state.weapons[0].set_movement(glm::vec3(0.0f));
+		state.weapons[0].set_speeds(0.0f, 0.0f, 0.0f);
+		state.weapons[0].set_acceleration(glm::vec3(0.0f));
+	}
+	if (state.player->is_facing_right)
+	{
+		state.weapons[0].set_position(state.player->get_position() + glm::vec3(1.0f, 0.0f, 0.0f));
+	}
+	else state.weapons[0].set_position(state.player->get_position() + glm::vec3(-1.0f, 0.0f, 0.0f));
+}
+
+/*
+* Hands one step's input to the player
+* Movement state only changes while a direction is held, same as the keyboard
+*
+* @param state, the current GAMESTATE
+* @param input, this step's PLAYERINPUT
+*/
+void apply_input(GameState& state, const PlayerInput& input)
+{
+	// reset player movement vector
+	state.player->set_movement(glm::vec3(0.0f));
+
+	if (input.direction < 0)
+	{
+		state.player->set_movement_state(input.movement_state);
+		state.player->move_left();
+		state.player->is_facing_right = false;
+	}
+	else if (input.direction > 0)
+	{
+		state.player->set_movement_state(input.movement_state);
+		state.player->is_facing_right = true;
+		state.player->move_right();
+	}
+
+	// Jump
+	if (input.jump && state.player->get_collided_bottom())
+	{
+		state.player->m_is_jumping = true;
+	}
+
+	// Trap Placement
+	if (input.place_trap) place_trap(state);
+}
+
+/*
+* Runs as many fixed steps as fit in the elapsed time
+* Leftover time is carried over in the accumulator
+* Only the live game uses this -- replays call apply_input and step_game_state
+* once per recorded step, so wall-clock time never changes the result
+*
+* @param state, the current GAMESTATE
+* @param input, applied before every step -- one-shot parts are cleared once used
+* @param delta_time, real-life time in seconds since the last call
+* @param accumulator, time left over from the previous call
+* @param log, if given, every step's input is recorded into it
+*
+* @return the number of fixed steps that ran
+*/
+int update_game_state(GameState& state, PlayerInput& input, float delta_time, float& accumulator, InputLog* log)
+{
+	delta_time += accumulator;
+
+	int steps = 0;
+	while (delta_time >= FIXED_TIMESTEP)
+	{
+		apply_input(state, input);
+		if (log) log->record(input);
+		input.jump = false;
+
+		step_game_state(state);
+		delta_time -= FIXED_TIMESTEP;
+		steps++;
+	}
+
+	accumulator = delta_time;
+	return steps;
+}
+
+/*
+* Advances every entity by exactly one FIXED_TIMESTEP
+* Enemies are updated in three passes so the velocity step runs as one
+* loop over the STORE -- same result as calling update on each in turn
+*
+* @param state, the current GAMESTATE
+*/
+void step_game_state(GameState& state)
+{
+	PROFILE_SCOPE("step_game_state");
+	state.player->update(FIXED_TIMESTEP, state.player, state.player, 1, state.map);
+
+	for (int i = 0; i < state.enemy_count; ++i)
+	{
+		state.enemies[i].begin_update(FIXED_TIMESTEP, state.player);
+	}
+	if (state.enemy_count > 0) state.store->integrate_velocities(state.enemies[0].get_index(), state.enemy_count, FIXED_TIMESTEP);
+	for (int i = 0; i < state.enemy_count; ++i)
+	{
+		state.enemies[i].finish_update(FIXED_TIMESTEP, state.player, 1, state.map);
+	}
+	if (state.trap_placed)
+	{
+		// one box against every enemy -- a straight scan, building a SPATIALGRID
+		// for a single query would cost as much as the scan it saves
+		PROFILE_SCOPE("trap collisions");
+		state.weapons[0].update(FIXED_TIMESTEP, state.player, state.enemies, state.enemy_count, state.map);
+	}
+
+	state.tick++;
+}
+
+/*
+* The game is over once the player is dead or every enemy is
+*
+* @param state, the current GAMESTATE
+*/
+bool is_game_over(const GameState& state)
+{
+	if (state.player->is_dead) return true;
+	for (int i = 0; i < state.enemy_count; ++i)
+	{
+		if (!state.enemies[i].is_dead) return false;
+	}
+	return true;
+}
+
+/*
+* FNV-1a over a run of bytes
+*/
+static uint64_t hash_bytes(uint64_t hash, const void* data, size_t size)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+template <typename T>
+static uint64_t hash_value(uint64_t hash, const T& value)
+{
+	return hash_bytes(hash, &value, sizeof(T));
+}
+
+static uint64_t hash_entity(uint64_t hash, const Entity& entity)
+{
+	hash = hash_value(hash, (int)entity.get_entity_type());
+	hash = hash_value(hash, (int)entity.get_player_state());
+	hash = hash_value(hash, (int)entity.get_ai_type());
+	hash = hash_value(hash, (int)entity.get_ai_state());
+	hash = hash_value(hash, entity.is_facing_right);
+	hash = hash_value(hash, entity.is_dead);
+	hash = hash_value(hash, entity.ability_timer);
+	hash = hash_value(hash, entity.ability_cooldown);
+	hash = hash_value(hash, entity.m_is_jumping);
+	hash = hash_value(hash, entity.get_walk_speed());
+	hash = hash_value(hash, entity.get_sprint_speed());
+	hash = hash_value(hash, entity.get_sneak_speed());
+	hash = hash_value(hash, entity.get_jumping_power());
+	hash = hash_value(hash, entity.get_continuous_collision());
+	hash = hash_value(hash, entity.get_spawn_position());
+	return hash;
+}
+
+/*
+* Hashes every bit of simulation state -- the STORE arrays, each ENTITY's
+* own fields (speeds, jumping power and spawn position included), the trap
+* and the random stream
+* Two runs are identical exactly when these match tick for tick
+*
+* @param state, the GAMESTATE to hash
+*/
+uint64_t hash_game_state(const GameState& state)
+{
+	const EntityStore& store = *state.store;
+	uint64_t hash = 14695981039346656037ULL;
+
+	hash = hash_bytes(hash, store.positions.data(), store.positions.size() * sizeof(glm::vec3));
+	hash = hash_bytes(hash, store.velocities.data(), store.velocities.size() * sizeof(glm::vec3));
+	hash = hash_bytes(hash, store.accelerations.data(), store.accelerations.size() * sizeof(glm::vec3));
+	hash = hash_bytes(hash, store.movements.data(), store.movements.size() * sizeof(glm::vec3));
+	hash = hash_bytes(hash, store.speeds.data(), store.speeds.size() * sizeof(float));
+	hash = hash_bytes(hash, store.widths.data(), store.widths.size() * sizeof(float));
+	hash = hash_bytes(hash, store.heights.data(), store.heights.size() * sizeof(float));
+	hash = hash_bytes(hash, store.flags.data(), store.flags.size());
+	hash = hash_value(hash, store.random.state);
+
+	hash = hash_entity(hash, *state.player);
+	for (int i = 0; i < state.enemy_count; ++i) hash = hash_entity(hash, state.enemies[i]);
+	for (size_t i = 0; i < 2; ++i) hash = hash_entity(hash, state.weapons[i]);
+	hash = hash_value(hash, state.trap_placed);
+
+	return hash;
+}
+
+/*
+* Frees everything initialise_game_state allocated
+*
+* @param state, the GAMESTATE to clear
+*/
+void shutdown_game_state(GameState& state)
+{
+	delete[] state.enemies;
+	delete[] state.weapons;
+	delete state.player;
+	delete state.map;
+	delete state.store;
+
+	state.enemies = nullptr;
+	state.weapons = nullptr;
+	state.player = nullptr;
+	state.map = nullptr;
+	state.store = nullptr;
+	state.enemy_count = 0;
+}
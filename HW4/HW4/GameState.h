@@ -0,0 +1,62 @@
+#pragma once
+#include "Entity.h"
+#include "Map.h"
+#include "EntityStore.h"
+
+#define FIXED_TIMESTEP 0.0166666f
+#define LEVEL1_WIDTH 14
+#define LEVEL1_HEIGHT 5
+#define ENEMY_COUNT 4 // level 1's -- generated levels have GameState::enemy_count
+
+class InputLog;
+struct GeneratedLevel;
+
+/*
+* Everything the simulation needs to step the game
+* No SDL or GL in here -- textures are attached by whoever renders it
+*/
+struct GameState
+{
+	// physics data for every ENTITY below, stored as separate arrays
+	EntityStore* store;
+
+	Entity* player;
+	Entity* enemies;
+	Entity* weapons;
+	int enemy_count = 0;
+
+	Map* map;
+
+	// weapon variables
+	bool trap_placed = false;
+
+	// fixed steps taken so far -- labels snapshots, not part of the hash
+	long tick = 0;
+};
+
+/*
+* One fixed step's worth of player input
+* The simulation only ever sees the player through this, so a list of
+* these plus the seed is enough to reproduce a run exactly
+*/
+struct PlayerInput
+{
+	int  direction = 0;            // -1 left, 0 none, 1 right
+	PlayerState movement_state = WALK; // only applied while moving
+	bool jump = false;             // one-shot, cleared once a step uses it
+	bool place_trap = false;       // held down
+};
+
+extern unsigned int LEVEL_1_DATA[];
+
+const uint64_t DEFAULT_SEED = 1;
+
+void initialise_game_state(GameState& state, unsigned int map_texture_id, uint64_t seed = DEFAULT_SEED);
+void initialise_generated_state(GameState& state, GeneratedLevel& level, unsigned int map_texture_id, uint64_t seed = DEFAULT_SEED);
+void place_trap(GameState& state);
+void apply_input(GameState& state, const PlayerInput& input);
+int  update_game_state(GameState& state, PlayerInput& input, float delta_time, float& accumulator, InputLog* log = nullptr);
+void step_game_state(GameState& state);
+bool is_game_over(const GameState& state);
+uint64_t hash_game_state(const GameState& state);
+void shutdown_game_state(GameState& state);
@@ -0,0 +1,281 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+/*
+* Headless driver for the simulation library
+* Steps level 1 for a fixed number of ticks as fast as the CPU allows
+* No window, no GL context -- only needs the HW4Sim library
+*
+* usage: HW4Headless [--trace <file>] [ticks] [worlds] [threads]
+*        HW4Headless [--trace <file>] --replay <file>
+*        HW4Headless [--trace <file>] --stress <width> <height> <enemies per type> [ticks]
+*   one world:   steps it for exactly ticks ticks
+*   many worlds: steps them in parallel until each is over or reaches ticks,
+*                each with different enemy speeds and ability cooldowns
+*   replay:      plays back a run recorded with HW4 --record, no rendering
+*   stress:      generates a level of that many tiles with that many of every
+*                animatronic, reports its memory, then steps it
+*   trace:       writes the profiler's Chrome trace when done -- needs an HW4_PROFILE build
+*/
+
+#define LOG(argument) std::cout << argument << '\n'
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "GameState.h"
+#include "Profiler.h"
+#include "InputLog.h"
+#include "LevelGenerator.h"
+#include "WorldBatch.h"
+
+const long DEFAULT_TICKS = 1000000;
+const long DEFAULT_STRESS_TICKS = 1000;
+
+/*
+* Steps a single world and reports ticks/second
+*
+* @param tick_count, number of fixed steps to run
+*/
+void run_single_world(long tick_count)
+{
+	GameState state;
+	initialise_game_state(state, 0);
+
+	auto start = std::chrono::steady_clock::now();
+	for (long tick = 0; tick < tick_count; tick++)
+	{
+		step_game_state(state);
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	LOG("ticks:          " << tick_count);
+	LOG("seconds:        " << seconds);
+	LOG("ticks/second:   " << (seconds > 0.0 ? tick_count / seconds : 0.0));
+	LOG("game over:      " << (is_game_over(state) ? "yes" : "no"));
+	LOG("player x, y:    " << state.player->get_position().x << ", " << state.player->get_position().y);
+	LOG("state hash:     " << std::hex << hash_game_state(state) << std::dec);
+
+	shutdown_game_state(state);
+}
+
+/*
+* Steps many differently tuned worlds in parallel and reports each outcome
+* Sprint speed and ability cooldown are spread over a grid of values
+*
+* @param max_ticks, the most ticks any one world runs
+* @param world_count, number of worlds
+* @param thread_count, worker threads -- 0 uses every core
+*/
+void run_world_batch(long max_ticks, int world_count, int thread_count)
+{
+	std::vector<WorldConfig> configs(world_count);
+	for (int world = 0; world < world_count; world++)
+	{
+		configs[world].sprint_speed = 1.0f + 0.5f * (world % 8);
+		configs[world].ability_cooldown = 0.5f + 0.5f * ((world / 8) % 8);
+		configs[world].max_ticks = max_ticks;
+		configs[world].seed = world + 1;
+	}
+
+	WorldBatch batch(configs);
+	batch.run(thread_count);
+
+	LOG(std::setw(8) << "world" << std::setw(10) << "sprint" << std::setw(10) << "cooldown"
+		<< std::setw(10) << "ticks" << std::setw(14) << "outcome" << std::setw(20) << "state hash");
+	uint64_t batch_hash = 0;
+	for (int world = 0; world < world_count; world++)
+	{
+		const WorldOutcome& outcome = batch.get_outcomes()[world];
+		batch_hash = batch_hash * 31 + outcome.state_hash;
+		const char* result = outcome.player_dead ? "player dead" : outcome.enemies_dead ? "enemies dead" : "timed out";
+
+		LOG(std::setw(8) << world << std::setw(10) << configs[world].sprint_speed
+			<< std::setw(10) << configs[world].ability_cooldown << std::setw(10) << outcome.ticks
+			<< std::setw(14) << result << std::setw(20) << std::hex << outcome.state_hash << std::dec);
+	}
+
+	LOG("worlds:         " << world_count);
+	LOG("total ticks:    " << batch.get_total_ticks());
+	LOG("seconds:        " << batch.get_seconds());
+	LOG("ticks/second:   " << batch.get_ticks_per_second());
+	LOG("batch hash:     " << std::hex << batch_hash << std::dec);
+}
+
+/*
+* Plays a recorded run back as fast as possible
+* The hash matches the recording's final state whenever the simulation
+* hasn't changed, so a recorded playthrough doubles as a regression check
+*
+* @param filepath, an input log written by HW4 --record
+*
+* @return false if the log can't be read
+*/
+bool run_replay(const char* filepath)
+{
+	InputLog log;
+	if (!log.load(filepath))
+	{
+		LOG("Unable to read input log " << filepath);
+		return false;
+	}
+
+	GameState state;
+	initialise_game_state(state, 0, log.get_seed());
+
+	long tick = 0;
+	auto start = std::chrono::steady_clock::now();
+	replay_to_end(state, log, tick);
+	auto end = std::chrono::steady_clock::now();
+
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	LOG("seed:           " << log.get_seed());
+	LOG("ticks:          " << tick);
+	LOG("seconds:        " << seconds);
+	LOG("ticks/second:   " << (seconds > 0.0 ? tick / seconds : 0.0));
+	LOG("game over:      " << (is_game_over(state) ? "yes" : "no"));
+	LOG("player x, y:    " << state.player->get_position().x << ", " << state.player->get_position().y);
+	LOG("state hash:     " << std::hex << hash_game_state(state) << std::dec);
+
+	shutdown_game_state(state);
+	return true;
+}
+
+/*
+* Generates a stress level and steps it -- reports how much memory the map and
+* entities take and how long a tick takes
+*
+* @param config, the level size, crowd and seed
+* @param tick_count, number of fixed steps to run
+*
+* @return false if the level is too small or the crowd too big to generate
+*/
+bool run_stress(const LevelConfig& config, long tick_count)
+{
+	auto start = std::chrono::steady_clock::now();
+	GeneratedLevel level;
+	if (!generate_level(config, level))
+	{
+		LOG("Unable to generate a " << config.width << "x" << config.height << " level with " << config.enemies_per_type << " of each enemy");
+		return false;
+	}
+	GameState state;
+	initialise_generated_state(state, level, 0, config.seed);
+	double generate_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	size_t map_bytes = state.map->get_collision_bytes();
+	size_t entity_bytes = state.store->get_bytes() + (state.enemy_count + 3) * sizeof(Entity);
+
+	start = std::chrono::steady_clock::now();
+	for (long tick = 0; tick < tick_count; tick++)
+	{
+		step_game_state(state);
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	LOG("level:          " << config.width << "x" << config.height << " tiles, "
+		<< state.map->get_solid_rect_count() << " solid rectangles");
+	LOG("enemies:        " << state.enemy_count);
+	LOG("generate s:     " << generate_seconds);
+	LOG("map bytes:      " << map_bytes);
+	LOG("entity bytes:   " << entity_bytes);
+	LOG("ticks:          " << tick_count);
+	LOG("seconds:        " << seconds);
+	LOG("ticks/second:   " << (seconds > 0.0 ? tick_count / seconds : 0.0));
+	LOG("ms/tick:        " << (tick_count > 0 ? seconds / tick_count * 1000.0 : 0.0));
+	LOG("game over:      " << (is_game_over(state) ? "yes" : "no"));
+	LOG("state hash:     " << std::hex << hash_game_state(state) << std::dec);
+
+	shutdown_game_state(state);
+	return true;
+}
+
+/*
+* Writes the trace if --trace was given
+*
+* @param filepath, the --trace file, or nullptr
+*/
+void finish_trace(const char* filepath)
+{
+	if (filepath == nullptr) return;
+	if (write_profile_trace(filepath)) LOG("trace:          " << filepath);
+	else LOG("Unable to write trace " << filepath << " -- build with -DHW4_PROFILE=ON");
+}
+
+int main(int argc, char* argv[])
+{
+	profile_name_thread("main");
+
+	// --trace <file> comes first, the rest of the arguments shift down past it
+	const char* trace_filepath = nullptr;
+	if (argc > 2 && std::string(argv[1]) == "--trace")
+	{
+		trace_filepath = argv[2];
+		argc -= 2;
+		argv += 2;
+	}
+
+	if (argc > 1 && std::string(argv[1]) == "--replay")
+	{
+		if (argc != 3)
+		{
+			LOG("usage: HW4Headless [--trace <file>] --replay <file>");
+			return 1;
+		}
+		bool replayed = run_replay(argv[2]);
+		finish_trace(trace_filepath);
+		return replayed ? 0 : 1;
+	}
+
+	if (argc > 1 && std::string(argv[1]) == "--stress")
+	{
+		LevelConfig config;
+		long stress_ticks = DEFAULT_STRESS_TICKS;
+		if (argc == 5 || argc == 6)
+		{
+			config.width = atoi(argv[2]);
+			config.height = atoi(argv[3]);
+			config.enemies_per_type = atoi(argv[4]);
+			if (argc == 6) stress_ticks = atol(argv[5]);
+		}
+		if (argc < 5 || argc > 6 || stress_ticks < 0)
+		{
+			LOG("usage: HW4Headless [--trace <file>] --stress <width> <height> <enemies per type> [ticks]");
+			return 1;
+		}
+		bool stepped = run_stress(config, stress_ticks);
+		finish_trace(trace_filepath);
+		return stepped ? 0 : 1;
+	}
+
+	long tick_count = DEFAULT_TICKS;
+	int world_count = 1;
+	int thread_count = 0;
+	if (argc > 1) tick_count = atol(argv[1]);
+	if (argc > 2) world_count = atoi(argv[2]);
+	if (argc > 3) thread_count = atoi(argv[3]);
+
+	if (tick_count <= 0 || world_count <= 0 || thread_count < 0)
+	{
+		LOG("usage: HW4Headless [--trace <file>] [ticks] [worlds] [threads]");
+		return 1;
+	}
+
+	if (world_count == 1) run_single_world(tick_count);
+	else run_world_batch(tick_count, world_count, thread_count);
+
+	finish_trace(trace_filepath);
+	return 0;
+}
@@ -0,0 +1,213 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <fstream>
+#include "InputLog.h"
+
+const char     LOG_MAGIC[4] = { 'H', 'W', '4', 'I' };
+const uint32_t LOG_VERSION = 1;
+
+// packed input byte -- 2 bits direction, 2 bits movement state, jump, trap
+const uint8_t DIRECTION_LEFT = 1;
+const uint8_t DIRECTION_RIGHT = 2;
+const uint8_t JUMP_BIT = 1 << 4;
+const uint8_t TRAP_BIT = 1 << 5;
+
+// longest log load accepts, a bit over a year of fixed steps -- runs are
+// run-length coded, so the file's size says nothing about the tick count
+const uint64_t MAX_LOG_TICKS = 1ULL << 31;
+
+uint8_t InputLog::pack(const PlayerInput& input)
+{
+	uint8_t packed = 0;
+	if (input.direction < 0) packed |= DIRECTION_LEFT;
+	if (input.direction > 0) packed |= DIRECTION_RIGHT;
+	packed |= ((uint8_t)input.movement_state & 3) << 2;
+	if (input.jump) packed |= JUMP_BIT;
+	if (input.place_trap) packed |= TRAP_BIT;
+	return packed;
+}
+
+PlayerInput InputLog::unpack(uint8_t packed)
+{
+	PlayerInput input;
+	if ((packed & 3) == DIRECTION_LEFT) input.direction = -1;
+	if ((packed & 3) == DIRECTION_RIGHT) input.direction = 1;
+	input.movement_state = (PlayerState)((packed >> 2) & 3);
+	input.jump = (packed & JUMP_BIT) != 0;
+	input.place_trap = (packed & TRAP_BIT) != 0;
+	return input;
+}
+
+/*
+* Empties the log for a new run
+*
+* @param seed, the seed the new run's GAMESTATE was initialised with
+*/
+void InputLog::clear(uint64_t seed)
+{
+	m_seed = seed;
+	m_ticks.clear();
+}
+
+static void write_u32(std::ofstream& file, uint32_t value)
+{
+	for (int i = 0; i < 4; i++) file.put((char)((value >> (8 * i)) & 0xff));
+}
+
+static void write_u64(std::ofstream& file, uint64_t value)
+{
+	for (int i = 0; i < 8; i++) file.put((char)((value >> (8 * i)) & 0xff));
+}
+
+static bool read_u64(std::ifstream& file, uint64_t& value, int bytes)
+{
+	value = 0;
+	for (int i = 0; i < bytes; i++)
+	{
+		int byte = file.get();
+		if (byte == EOF) return false;
+		value |= (uint64_t)byte << (8 * i);
+	}
+	return true;
+}
+
+/*
+* Writes the log as runs of identical steps
+*
+* @param filepath, where to write it
+*
+* @return false if the file couldn't be written
+*/
+bool InputLog::save(const std::string& filepath) const
+{
+	std::ofstream file(filepath, std::ios::binary);
+	if (!file) return false;
+
+	file.write(LOG_MAGIC, sizeof(LOG_MAGIC));
+	write_u32(file, LOG_VERSION);
+	write_u64(file, m_seed);
+	write_u64(file, (uint64_t)m_ticks.size());
+
+	size_t tick = 0;
+	while (tick < m_ticks.size())
+	{
+		uint8_t packed = m_ticks[tick];
+		uint64_t run = 1;
+		while (tick + run < m_ticks.size() && m_ticks[tick + run] == packed) run++;
+
+		file.put((char)packed);
+		for (uint64_t rest = run; ; rest >>= 7)
+		{
+			if (rest < 0x80) { file.put((char)rest); break; }
+			file.put((char)((rest & 0x7f) | 0x80));
+		}
+
+		tick += run;
+	}
+
+	return (bool)file;
+}
+
+/*
+* Reads a log written by save
+*
+* @param filepath, the log to read
+*
+* @return false if the file is missing, not an input log, cut short, or corrupt
+*/
+bool InputLog::load(const std::string& filepath)
+{
+	std::ifstream file(filepath, std::ios::binary);
+	if (!file) return false;
+
+	char magic[4];
+	uint64_t version, seed, tick_count;
+	if (!file.read(magic, sizeof(magic)) || std::string(magic, 4) != std::string(LOG_MAGIC, 4)) return false;
+	if (!read_u64(file, version, 4) || version != LOG_VERSION) return false;
+	if (!read_u64(file, seed, 8) || !read_u64(file, tick_count, 8)) return false;
+
+	if (tick_count > MAX_LOG_TICKS) return false;
+
+	// no reserve -- the count isn't trusted until the runs add up to it
+	clear(seed);
+
+	while (m_ticks.size() < tick_count)
+	{
+		int packed = file.get();
+		if (packed == EOF) return false;
+		if (((packed >> 2) & 3) > SNEAK) return false; // no such PLAYERSTATE
+		if ((packed & 3) == (DIRECTION_LEFT | DIRECTION_RIGHT)) return false; // pack never sets both
+		if (packed & 0xc0) return false; // bits past TRAP_BIT are unused
+
+		uint64_t run = 0;
+		for (int shift = 0; ; shift += 7)
+		{
+			int byte = file.get();
+			if (byte == EOF || shift > 56) return false;
+			run |= (uint64_t)(byte & 0x7f) << shift;
+			if (!(byte & 0x80)) break;
+		}
+		if (run > tick_count - m_ticks.size()) return false;
+
+		m_ticks.insert(m_ticks.end(), (size_t)run, (uint8_t)packed);
+	}
+
+	return true;
+}
+
+/*
+* Real-time replay -- same fixed-timestep loop as update_game_state, but each
+* step takes the next recorded input instead of the keyboard
+*
+* @param state, a GAMESTATE initialised with the log's seed
+* @param log, the recorded run
+* @param tick, the next recorded step to play -- advanced as steps run
+* @param delta_time, real-life time in seconds since the last call
+* @param accumulator, time left over from the previous call
+*
+* @return the number of fixed steps that ran
+*/
+int replay_game_state(GameState& state, const InputLog& log, long& tick, float delta_time, float& accumulator)
+{
+	delta_time += accumulator;
+
+	int steps = 0;
+	while (delta_time >= FIXED_TIMESTEP && tick < log.size())
+	{
+		apply_input(state, log.get(tick++));
+		step_game_state(state);
+		delta_time -= FIXED_TIMESTEP;
+		steps++;
+	}
+
+	accumulator = delta_time;
+	return steps;
+}
+
+/*
+* Fast-forward replay -- plays every remaining recorded step back to back
+*
+* @param state, a GAMESTATE initialised with the log's seed
+* @param log, the recorded run
+* @param tick, the next recorded step to play -- ends at log.size()
+*
+* @return the number of fixed steps that ran
+*/
+long replay_to_end(GameState& state, const InputLog& log, long& tick)
+{
+	long first = tick;
+	while (tick < log.size())
+	{
+		apply_input(state, log.get(tick++));
+		step_game_state(state);
+	}
+	return tick - first;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "GameState.h"
+
+/*
+* Every fixed step's PLAYERINPUT for one run, plus the seed it started from
+* That's all it takes to reproduce the run -- see GameState.h
+*
+* On disk: "HW4I", version, seed, tick count, then runs of identical steps
+* as (packed input byte, LEB128 run length) -- a held key costs a few bytes
+*/
+class InputLog
+{
+private:
+	uint64_t m_seed = DEFAULT_SEED;
+	std::vector<uint8_t> m_ticks; // one packed input per fixed step
+
+public:
+	static uint8_t     pack(const PlayerInput& input);
+	static PlayerInput unpack(uint8_t packed);
+
+	void clear(uint64_t seed);
+	void record(const PlayerInput& input) { m_ticks.push_back(pack(input)); }
+	PlayerInput get(long tick) const { return unpack(m_ticks[tick]); }
+
+	bool save(const std::string& filepath) const;
+	bool load(const std::string& filepath);
+
+	// GETTERS
+	uint64_t const get_seed() const { return m_seed; }
+	long     const size()     const { return (long)m_ticks.size(); }
+};
+
+int  replay_game_state(GameState& state, const InputLog& log, long& tick, float delta_time, float& accumulator);
+long replay_to_end(GameState& state, const InputLog& log, long& tick);
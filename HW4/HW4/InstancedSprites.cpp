@@ -0,0 +1,166 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cstddef>
+#include "InstancedSprites.h"
+#include "RenderState.h"
+
+/*
+* Makes the shared quad and the instance buffer -- call once the GL context exists
+*
+* @param program, the SHADERPROGRAM loaded from vertex_instanced.glsl
+*/
+void InstancedSprites::initialise(ShaderProgram* program)
+{
+	// unit quad, same corners and UVs as Entity::render -- x, y, u, v
+	float quad[] = {
+		-0.5f, -0.5f, 0.0f, 1.0f,
+		 0.5f, -0.5f, 1.0f, 1.0f,
+		 0.5f,  0.5f, 1.0f, 0.0f,
+		-0.5f, -0.5f, 0.0f, 1.0f,
+		 0.5f,  0.5f, 1.0f, 0.0f,
+		-0.5f,  0.5f, 0.0f, 0.0f
+	};
+
+	glGenBuffers(1, &m_quad_buffer);
+	glGenBuffers(1, &m_instance_buffer);
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_quad_buffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	m_rect_attribute = program->get_attribute_location("instanceRect");
+	m_atlas_attribute = program->get_attribute_location("instanceAtlas");
+	m_flip_attribute = program->get_attribute_location("instanceFlip");
+}
+
+void InstancedSprites::shutdown()
+{
+	glDeleteBuffers(1, &m_quad_buffer);
+	glDeleteBuffers(1, &m_instance_buffer);
+	m_quad_buffer = 0;
+	m_instance_buffer = 0;
+}
+
+// starts a new frame's sprites
+void InstancedSprites::begin()
+{
+	m_sprites.clear();
+}
+
+/*
+* Queues one sprite -- nothing reaches GL until end()
+*
+* @param texture_id, the sprite's texture
+* @param position, centre of the sprite in world space
+* @param width, height, size in world units -- entities are 1x1
+* @param atlas, u, v, width, height of the sprite within its texture
+* @param flip, mirror the sprite left to right
+* @param layer, lower layers are drawn first, whatever their texture -- -32768 to 32767
+*/
+void InstancedSprites::draw(GLuint texture_id, glm::vec3 position, float width, float height,
+	glm::vec4 atlas, bool flip, int layer)
+{
+	Sprite sprite;
+	// biased so negative layers sort below positive ones
+	sprite.key = ((uint64_t)(uint16_t)(layer + 0x8000) << 48) | ((uint64_t)(texture_id & 0xffff) << 32) | (uint32_t)m_sprites.size();
+	sprite.texture_id = texture_id;
+	sprite.instance = { { position.x, position.y, width, height }, { atlas.x, atlas.y, atlas.z, atlas.w }, flip ? -1.0f : 1.0f };
+	m_sprites.push_back(sprite);
+}
+
+/*
+* Sorts the frame's sprites, uploads their instance records and draws them
+*
+* @param program, the SHADERPROGRAM loaded from vertex_instanced.glsl
+*/
+void InstancedSprites::end(ShaderProgram* program)
+{
+	m_draw_calls = 0;
+	m_sprite_count = (int)m_sprites.size();
+	if (m_sprites.empty()) return;
+
+	std::sort(m_sprites.begin(), m_sprites.end(),
+		[](const Sprite& a, const Sprite& b) { return a.key < b.key; });
+
+	m_instances.resize(m_sprites.size());
+	for (size_t i = 0; i < m_sprites.size(); i++) m_instances[i] = m_sprites[i].instance;
+
+	g_render_state.use_program(program->get_program_id());
+
+	// the other shader's attributes may sit at these locations -- only ours stay on
+	GLuint position_attribute = program->get_position_attribute();
+	GLuint tex_coord_attribute = program->get_tex_coordinate_attribute();
+	GLuint instance_attributes[] = { m_rect_attribute, m_atlas_attribute, m_flip_attribute };
+	g_render_state.disable_other_attributes(RenderState::attribute_bit(position_attribute)
+		| RenderState::attribute_bit(tex_coord_attribute) | RenderState::attribute_bit(m_rect_attribute)
+		| RenderState::attribute_bit(m_atlas_attribute) | RenderState::attribute_bit(m_flip_attribute));
+
+	GLsizei quad_stride = 4 * sizeof(float);
+	glBindBuffer(GL_ARRAY_BUFFER, m_quad_buffer);
+	glVertexAttribPointer(position_attribute, 2, GL_FLOAT, false, quad_stride, (const void*)0);
+	glVertexAttribPointer(tex_coord_attribute, 2, GL_FLOAT, false, quad_stride, (const void*)(2 * sizeof(float)));
+	g_render_state.enable_attribute(position_attribute);
+	g_render_state.enable_attribute(tex_coord_attribute);
+
+	// orphan last frame's storage so the driver never waits on the GPU
+	glBindBuffer(GL_ARRAY_BUFFER, m_instance_buffer);
+	glBufferData(GL_ARRAY_BUFFER, m_instances.size() * sizeof(SpriteInstance), nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, m_instances.size() * sizeof(SpriteInstance), m_instances.data());
+
+	for (GLuint attribute : instance_attributes)
+	{
+		g_render_state.enable_attribute(attribute);
+		glVertexAttribDivisor(attribute, 1);
+	}
+
+	// one instanced draw per run of the same texture
+	size_t run_start = 0;
+	while (run_start < m_sprites.size())
+	{
+		GLuint texture_id = m_sprites[run_start].texture_id;
+		size_t run_end = run_start + 1;
+		while (run_end < m_sprites.size() && m_sprites[run_end].texture_id == texture_id) run_end++;
+
+		point_instances(run_start);
+		g_render_state.bind_texture(texture_id);
+		glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei)(run_end - run_start));
+		m_draw_calls++;
+
+		run_start = run_end;
+	}
+
+	// divisors stick to the attribute slot -- put them back for the other shader
+	for (GLuint attribute : instance_attributes)
+	{
+		glVertexAttribDivisor(attribute, 0);
+		g_render_state.disable_attribute(attribute);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/*
+* Points the instance attributes at a run's first record
+* Cheaper than base-instance draws, which need GL 4.2
+*
+* @param first, index of the run's first instance
+*/
+void InstancedSprites::point_instances(size_t first)
+{
+	GLsizei stride = sizeof(SpriteInstance);
+	size_t offset = first * sizeof(SpriteInstance);
+
+	glVertexAttribPointer(m_rect_attribute, 4, GL_FLOAT, false, stride, (const void*)(offset + offsetof(SpriteInstance, rect)));
+	glVertexAttribPointer(m_atlas_attribute, 4, GL_FLOAT, false, stride, (const void*)(offset + offsetof(SpriteInstance, atlas)));
+	glVertexAttribPointer(m_flip_attribute, 1, GL_FLOAT, false, stride, (const void*)(offset + offsetof(SpriteInstance, flip)));
+}
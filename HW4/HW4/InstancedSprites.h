@@ -0,0 +1,68 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include <stdint.h>
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "ShaderProgram.h"
+
+/*
+* Instanced alternative to SPRITEBATCH, drawn with shaders/vertex_instanced.glsl
+* One shared quad, plus a small per-instance record for every sprite, so the
+* CPU writes 36 bytes a sprite instead of four corners. Each run of the same
+* texture is a single glDrawArraysInstanced call
+*
+* usage: initialise(program) once -> begin() -> draw() for each sprite -> end(program)
+*/
+class InstancedSprites
+{
+private:
+	// matches the instance attributes in vertex_instanced.glsl
+	struct SpriteInstance
+	{
+		float rect[4];  // centre x, centre y, width, height
+		float atlas[4]; // u, v, width, height in the texture
+		float flip;
+	};
+
+	struct Sprite
+	{
+		uint64_t key; // layer, texture, then draw order -- same ordering as SPRITEBATCH
+		GLuint   texture_id;
+		SpriteInstance instance;
+	};
+
+	std::vector<Sprite>         m_sprites;
+	std::vector<SpriteInstance> m_instances;
+
+	GLuint m_quad_buffer = 0;
+	GLuint m_instance_buffer = 0;
+
+	GLuint m_rect_attribute = 0;
+	GLuint m_atlas_attribute = 0;
+	GLuint m_flip_attribute = 0;
+
+	// last frame's numbers
+	int m_draw_calls = 0;
+	int m_sprite_count = 0;
+
+	void point_instances(size_t first);
+
+public:
+	void initialise(ShaderProgram* program);
+	void shutdown();
+
+	void begin();
+	void draw(GLuint texture_id, glm::vec3 position, float width = 1.0f, float height = 1.0f,
+		glm::vec4 atlas = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), bool flip = false, int layer = 0);
+	void end(ShaderProgram* program);
+
+	// GETTERS
+	int const get_draw_calls()   const { return m_draw_calls; };
+	int const get_sprite_count() const { return m_sprite_count; };
+};
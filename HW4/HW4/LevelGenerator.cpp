@@ -0,0 +1,126 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <climits>
+#include "LevelGenerator.h"
+#include "Random.h"
+#include "Profiler.h"
+
+// tile set positions, used the way LEVEL_1_DATA uses them
+const unsigned int PLATFORM_TILE = 1;
+const unsigned int FLOOR_TILES[] = { 3, 2 }; // the floor's two looks, swapped run by run
+const unsigned int EARTH_TILE = 2;           // everything under the floor
+
+// rows between bands of platforms -- always room to stand on one and walk under the next
+const int PLATFORM_GAP = 4;
+
+// no enemy starts on the floor this close to the player
+const int SPAWN_CLEARANCE = 16;
+
+// a platform enemies can be placed on
+struct Ledge
+{
+	int x, row, length;
+};
+
+// world position of an ENTITY standing on the tile at column, row
+static glm::vec3 standing_on(int column, int row)
+{
+	return glm::vec3(column * GENERATED_TILE_SIZE, -(row - 1) * GENERATED_TILE_SIZE, 0.0f);
+}
+
+/*
+* Builds a level for stress testing -- a floor of flat runs that step up and
+* down, bands of floating platforms above it up to the top of the level, and
+* enemies_per_type of every animatronic standing on the floor or the platforms
+*
+* @param config, size, crowd and seed
+* @param level, receives the tiles and where everything spawns
+*
+* @return false if the config is too small to lay a level out in, or asks for
+* more enemies than an int can count
+*/
+bool generate_level(const LevelConfig& config, GeneratedLevel& level)
+{
+	PROFILE_SCOPE("generate_level");
+	if (config.width < 2 * SPAWN_CLEARANCE || config.height < 16) return false;
+	// every AITYPE gets enemies_per_type, and the total has to fit GAMESTATE's int enemy_count
+	if (config.enemies_per_type < 0 || config.enemies_per_type > INT_MAX / 4) return false;
+
+	int width = config.width;
+	int height = config.height;
+	level.width = width;
+	level.height = height;
+	level.tiles.assign((size_t)width * height, 0);
+
+	Random random;
+	random.seed(config.seed);
+
+	// FLOOR -- runs of 16 to 64 tiles, each up to two rows above or below the last
+	int lowest = height - 2;
+	int highest = height - std::max(4, height / 4);
+	std::vector<int> floor_row(width);
+
+	int run_row = (lowest + highest) / 2;
+	int look = 0;
+	for (int x = 0; x < width; )
+	{
+		int run_end = std::min(width, x + 16 + random.range(49));
+		for (; x < run_end; x++)
+		{
+			floor_row[x] = run_row;
+			level.tiles[(size_t)run_row * width + x] = FLOOR_TILES[look];
+			for (int below = run_row + 1; below < height; below++) level.tiles[(size_t)below * width + x] = EARTH_TILE;
+		}
+		run_row = std::min(lowest, std::max(highest, run_row + random.range(5) - 2));
+		look = 1 - look;
+	}
+
+	// PLATFORMS -- a band every PLATFORM_GAP rows from just over the highest floor to the top,
+	// each a row of 3 to 16 tiles with a gap of 4 to 24 before the next
+	std::vector<Ledge> ledges;
+	for (int band = highest - PLATFORM_GAP; band >= 2; band -= PLATFORM_GAP)
+	{
+		for (int x = random.range(16); x < width; )
+		{
+			Ledge ledge = { x, band - random.range(2), std::min(width - x, 3 + random.range(14)) };
+			for (int i = 0; i < ledge.length; i++) level.tiles[(size_t)ledge.row * width + ledge.x + i] = PLATFORM_TILE;
+			if (ledge.x >= SPAWN_CLEARANCE) ledges.push_back(ledge);
+
+			x += ledge.length + 4 + random.range(21);
+		}
+	}
+
+	// SPAWNS -- the player near the left end, each enemy on a random floor column or ledge
+	level.player_spawn = standing_on(2, floor_row[2]);
+
+	level.enemies.clear();
+	int enemy_count = config.enemies_per_type * 4;
+	level.enemies.reserve((size_t)enemy_count);
+	for (int i = 0; i < enemy_count; i++)
+	{
+		int column, row;
+		if (ledges.empty() || random.range(2) == 0)
+		{
+			column = SPAWN_CLEARANCE + random.range(width - SPAWN_CLEARANCE);
+			row = floor_row[column];
+		}
+		else
+		{
+			const Ledge& ledge = ledges[random.range((int)ledges.size())];
+			column = ledge.x + random.range(ledge.length);
+			row = ledge.row;
+		}
+		level.enemies.push_back({ (AIType)(i % 4), standing_on(column, row) });
+	}
+
+	return true;
+}
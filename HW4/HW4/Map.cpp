@@ -8,99 +8,229 @@
 * Academic Misconduct.
 **/
 
+#include <algorithm>
 #include "Map.h"
+#include "Profiler.h"
+
+#if defined(__AVX__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+/*
+* Map Constructor Override
+* Copies the level, so the array it came from is never changed
+*/
+Map::Map(int width, int height, unsigned int* level_data, unsigned int texture_id, float tile_size, int tile_count_x, int tile_count_y)
+	: Map(width, height, std::vector<unsigned int>(level_data, level_data + (size_t)width * height),
+		texture_id, tile_size, tile_count_x, tile_count_y)
+{
+}
 
 /*
 * Map Constructor Override
+* Only sets up the collision data -- the render mesh is built separately
+* by build() so the headless simulation never pays for it
+*
+* @param level_data, width * height tile set positions row by row -- moved into the map
 */
-Map::Map(int width, int height, unsigned int* level_data, GLuint texture_id, float tile_size, int tile_count_x, int tile_count_y)
+Map::Map(int width, int height, std::vector<unsigned int>&& level_data, unsigned int texture_id, float tile_size,
+	int tile_count_x, int tile_count_y)
 {
+	PROFILE_SCOPE("Map::Map");
 	m_width = width;
 	m_height = height;
 
-	m_level_data = level_data;
+	m_level_data = std::move(level_data);
 	m_texture_id = texture_id;
 
 	m_tile_size = tile_size;
 	m_tile_count_x = tile_count_x;
 	m_tile_count_y = tile_count_y;
 
-	build();
+	// MAKE SURE TO UPDATE BOUNDS IF SIZE OF TILES CHANGES
+	m_left_bound = 0 - (m_tile_size / 2);
+	m_right_bound = (m_tile_size * m_width) - (m_tile_size / 2);
+	m_top_bound = 0 + (m_tile_size / 2);
+	m_bottom_bound = -(m_tile_size * m_height) + (m_tile_size / 2);
+
+	// pack solid / empty so collision never has to read m_level_data
+	m_solid_bits.assign(((size_t)m_width * m_height + 63) / 64, 0);
+	for (int tile = 0; tile < m_width * m_height; tile++)
+	{
+		if (m_level_data[tile] != 0) m_solid_bits[tile >> 6] |= (uint64_t)1 << (tile & 63);
+	}
+	m_dirty_bits.assign(m_solid_bits.size(), 0);
+
+	// merged solid rectangles, chunk by chunk so an edit only redoes its own chunk
+	m_chunk_count_x = (m_width + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE;
+	m_chunk_count_y = (m_height + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE;
+	m_solid_rects.resize((size_t)m_chunk_count_x * m_chunk_count_y);
+	m_solid_rect_count = 0;
+	for (int chunk_y = 0; chunk_y < m_chunk_count_y; chunk_y++)
+	{
+		for (int chunk_x = 0; chunk_x < m_chunk_count_x; chunk_x++)
+		{
+			std::vector<TileRect>& rects = m_solid_rects[chunk_y * m_chunk_count_x + chunk_x];
+			merge_tiles(chunk_x, chunk_y, false, rects);
+			m_solid_rect_count += (int)rects.size();
+		}
+	}
+}
+
+/*
+* Changes one tile -- collision sees it straight away, the render mesh catches up
+* on the next update_mesh(), so every edit made in a tick goes up together
+*
+* @param tile_x, tile_y, the tile's column and row, rows counting down from the top
+* @param tile, the new tile set position, 0 for air
+*/
+void Map::set_tile(int tile_x, int tile_y, unsigned int tile)
+{
+	PROFILE_SCOPE("Map::set_tile");
+	if (tile_x < 0 || tile_x >= m_width || tile_y < 0 || tile_y >= m_height) return;
+
+	int index = tile_y * m_width + tile_x;
+	if (m_level_data[index] == tile) return;
+	bool was_solid = m_level_data[index] != 0;
+	m_level_data[index] = tile;
+
+	uint64_t bit = (uint64_t)1 << (index & 63);
+	if (tile != 0) m_solid_bits[index >> 6] |= bit;
+	else           m_solid_bits[index >> 6] &= ~bit;
+
+	if (!(m_dirty_bits[index >> 6] & bit))
+	{
+		m_dirty_bits[index >> 6] |= bit;
+		m_dirty_tiles.push_back(index);
+	}
+
+	// a tile changing its look but not its solidity leaves the rectangles as they are
+	if ((m_level_data[index] != 0) == was_solid) return;
+
+	std::vector<TileRect>& rects = m_solid_rects[(tile_y / MAP_CHUNK_SIZE) * m_chunk_count_x + tile_x / MAP_CHUNK_SIZE];
+	m_solid_rect_count -= (int)rects.size();
+	merge_tiles(tile_x / MAP_CHUNK_SIZE, tile_y / MAP_CHUNK_SIZE, false, rects);
+	m_solid_rect_count += (int)rects.size();
 }
 
-void Map::build()
+/*
+* Greedy meshing of one chunk -- each rectangle starts at the first tile not yet
+* covered (row by row), grows right while the tiles match, then grows down while
+* the whole row below matches. Rectangles never cross a chunk edge
+*
+* @param chunk_x, chunk_y, which chunk
+* @param match_tile, true merges only identical tiles (the render mesh), false merges
+* any solid tiles (collision)
+* @param rects, cleared and filled with the chunk's rectangles
+*/
+void Map::merge_tiles(int chunk_x, int chunk_y, bool match_tile, std::vector<TileRect>& rects) const
 {
-	// maps out tiles in the y
-	for (int y_coord = 0; y_coord < m_height; y_coord++)
+	PROFILE_SCOPE("Map::merge_tiles");
+	rects.clear();
+
+	int first_x = chunk_x * MAP_CHUNK_SIZE;
+	int first_y = chunk_y * MAP_CHUNK_SIZE;
+	int last_x = std::min(first_x + MAP_CHUNK_SIZE, m_width);
+	int last_y = std::min(first_y + MAP_CHUNK_SIZE, m_height);
+
+	// one bit per column for each of the chunk's rows
+	uint32_t covered[MAP_CHUNK_SIZE] = {};
+
+	for (int y = first_y; y < last_y; y++)
 	{
-		// maps out tiles in the x
-		for (int x_coord = 0; x_coord < m_width; x_coord++)
+		for (int x = first_x; x < last_x; x++)
 		{
-			// current tile
-			int tile = m_level_data[y_coord * m_width + x_coord];
+			unsigned int tile = m_level_data[y * m_width + x];
 
 			// EMPTY TILES/AIR ARE DENOTED AS 0
-			if (tile == 0) continue;
-
-			float u_coord = (float)(tile % m_tile_count_x) / (float)m_tile_count_x;
-			float v_coord = (float)(tile / m_tile_count_x) / (float)m_tile_count_y;
-
-			// dimensions of each tile and its position
-			float tile_width = 1.0f / (float) m_tile_count_x;
-			float tile_height = 1.0f / (float) m_tile_count_y;
-
-			// get radius
-			float x_offset = -(m_tile_size / 2);
-			float y_offset = (m_tile_size / 2);
-			
-			// store updated / calculated vertices and textures 
-			m_vertices.insert(m_vertices.end(), {
-				x_offset + (m_tile_size * x_coord),  y_offset + -m_tile_size * y_coord,
-				x_offset + (m_tile_size * x_coord),  y_offset + (-m_tile_size * y_coord) - m_tile_size,
-				x_offset + (m_tile_size * x_coord) + m_tile_size, y_offset + (-m_tile_size * y_coord) - m_tile_size,
-				x_offset + (m_tile_size * x_coord), y_offset + -m_tile_size * y_coord,
-				x_offset + (m_tile_size * x_coord) + m_tile_size, y_offset + (-m_tile_size * y_coord) - m_tile_size,
-				x_offset + (m_tile_size * x_coord) + m_tile_size, y_offset + -m_tile_size * y_coord
-				});
-
-			m_texture_coordinates.insert(m_texture_coordinates.end(), {
-				u_coord, v_coord,
-				u_coord, v_coord + (tile_height),
-				u_coord + tile_width, v_coord + (tile_height),
-				u_coord, v_coord,
-				u_coord + tile_width, v_coord + (tile_height),
-				u_coord + tile_width, v_coord
-			});
+			if (tile == 0 || (covered[y - first_y] >> (x - first_x)) & 1) continue;
+
+			auto matches = [&](int tile_x, int tile_y) {
+				unsigned int other = m_level_data[tile_y * m_width + tile_x];
+				return !((covered[tile_y - first_y] >> (tile_x - first_x)) & 1) && (match_tile ? other == tile : other != 0);
+			};
+
+			int end_x = x + 1;
+			while (end_x < last_x && matches(end_x, y)) end_x++;
+
+			int end_y = y + 1;
+			while (end_y < last_y)
+			{
+				int column = x;
+				while (column < end_x && matches(column, end_y)) column++;
+				if (column < end_x) break;
+				end_y++;
+			}
+
+			uint32_t columns = (uint32_t)(((uint64_t)1 << (end_x - first_x)) - ((uint64_t)1 << (x - first_x)));
+			for (int row = y; row < end_y; row++) covered[row - first_y] |= columns;
+
+			rects.push_back({ x, y, end_x - x, end_y - y, match_tile ? tile : 0u });
 		}
 	}
-
-	// MAKE SURE TO UPDATE BOUNDS IF SIZE OF TILES CHANGES
-	m_left_bound = 0 - (m_tile_size / 2);
-	m_right_bound = (m_tile_size * m_width) - (m_tile_size / 2);
-	m_top_bound = 0 + (m_tile_size / 2);
-	m_bottom_bound = -(m_tile_size * m_height) + (m_tile_size / 2);
 }
 
-void Map::render(ShaderProgram* program)
+/*
+* Collects the merged solid rectangles an AABB overlaps
+* Only the chunks under the box are looked at, and a rectangle never crosses a
+* chunk edge, so nothing is listed twice
+*
+* @param position, centre of the box
+* @param width, height, size of the box
+* @param rects, cleared and filled with the overlapping rectangles, in tile units
+*/
+void Map::query_solid_rects(glm::vec3 position, float width, float height, std::vector<TileRect>& rects) const
 {
-	glm::mat4 model_matrix = glm::mat4(1.0f);
-	program->set_model_matrix(model_matrix);
+	PROFILE_SCOPE("Map::query_solid_rects");
+	rects.clear();
 
-	glUseProgram(program->get_program_id());
+	// box edges in tile units, same as sweep -- rows count up as Y goes down
+	float half = m_tile_size / 2;
+	float left = (position.x - (width / 2) + half) / m_tile_size;
+	float right = (position.x + (width / 2) + half) / m_tile_size;
+	float top = (-(position.y + (height / 2)) + half) / m_tile_size;
+	float bottom = (-(position.y - (height / 2)) + half) / m_tile_size;
 
-	glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, 0, m_vertices.data());
-	glEnableVertexAttribArray(program->get_position_attribute());
-	glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, 0, m_texture_coordinates.data());
-	glEnableVertexAttribArray(program->get_tex_coordinate_attribute());
+	if (right < 0.0f || bottom < 0.0f) return;
 
-	glBindTexture(GL_TEXTURE_2D, m_texture_id);
+	int first_chunk_x = std::max((int)floor(left) / MAP_CHUNK_SIZE, 0);
+	int last_chunk_x = std::min((int)floor(right) / MAP_CHUNK_SIZE, m_chunk_count_x - 1);
+	int first_chunk_y = std::max((int)floor(top) / MAP_CHUNK_SIZE, 0);
+	int last_chunk_y = std::min((int)floor(bottom) / MAP_CHUNK_SIZE, m_chunk_count_y - 1);
 
-	glDrawArrays(GL_TRIANGLES, 0, (int)m_vertices.size() / 2);
-	glDisableVertexAttribArray(program->get_position_attribute());
-	glDisableVertexAttribArray(program->get_tex_coordinate_attribute());
+	for (int chunk_y = first_chunk_y; chunk_y <= last_chunk_y; chunk_y++)
+	{
+		for (int chunk_x = first_chunk_x; chunk_x <= last_chunk_x; chunk_x++)
+		{
+			for (const TileRect& rect : m_solid_rects[chunk_y * m_chunk_count_x + chunk_x])
+			{
+				if (rect.x < right && rect.x + rect.width > left && rect.y < bottom && rect.y + rect.height > top)
+				{
+					rects.push_back(rect);
+				}
+			}
+		}
+	}
 }
 
-bool Map::is_solid(glm::vec3 position, float* penetration_x, float* penetration_y)
+// heap memory the collision side holds -- tiles, solid and dirty bits, merged rectangles
+size_t Map::get_collision_bytes() const
+{
+	size_t bytes = m_level_data.capacity() * sizeof(unsigned int)
+		+ (m_solid_bits.capacity() + m_dirty_bits.capacity()) * sizeof(uint64_t)
+		+ m_solid_rects.capacity() * sizeof(std::vector<TileRect>);
+	for (const std::vector<TileRect>& rects : m_solid_rects) bytes += rects.capacity() * sizeof(TileRect);
+	return bytes;
+}
+
+// forgets the pending edits -- for renderers that have applied them, or have no mesh at all
+void Map::clear_dirty_tiles()
+{
+	for (int index : m_dirty_tiles) m_dirty_bits[index >> 6] &= ~((uint64_t)1 << (index & 63));
+	m_dirty_tiles.clear();
+}
+
+bool Map::is_solid(glm::vec3 position, float* penetration_x, float* penetration_y) const
 {
 	*penetration_x = 0;
 	*penetration_y = 0;
@@ -114,8 +244,7 @@ bool Map::is_solid(glm::vec3 position, float* penetration_x, float* penetration_
 	if (tile_x < 0 || tile_x >= m_width)  return false;
 	if (tile_y < 0 || tile_y >= m_height) return false;
 
-	int tile = m_level_data[tile_y * m_width + tile_x];
-	if (tile == 0) return false;
+	if (!is_solid_tile(tile_x, tile_y)) return false;
 
 	float tile_center_x = (tile_x * m_tile_size);
 	float tile_center_y = -(tile_y * m_tile_size);
@@ -124,4 +253,259 @@ bool Map::is_solid(glm::vec3 position, float* penetration_x, float* penetration_
 	*penetration_y = (m_tile_size / 2) - fabs(position.y - tile_center_y);
 
 	return true;
-}
\ No newline at end of file
+}
+
+/*
+* Runs is_solid over many points in one pass
+* Bounds, tile index and penetration are worked out LANES points at a time,
+* then each in-bounds lane looks its tile up in the bitmap
+* The math is the same float math as is_solid, so results match bit for bit
+*
+* @param x, x coordinate of every point
+* @param y, y coordinate of every point
+* @param count, number of points
+* @param solid, set per point like is_solid's return value
+* @param penetration_x, set per point like is_solid's penetration_x
+* @param penetration_y, set per point like is_solid's penetration_y
+*/
+void Map::is_solid_batch(const float* x, const float* y, int count,
+	bool* solid, float* penetration_x, float* penetration_y) const
+{
+	int i = 0;
+
+#if defined(__AVX__) || defined(__SSE4_1__)
+#if defined(__AVX__)
+	const int LANES = 8;
+	typedef __m256 vec;
+	typedef __m256i ivec;
+#define VSET1(v)       _mm256_set1_ps(v)
+#define VLOAD(p)       _mm256_loadu_ps(p)
+#define VSTORE(p, v)   _mm256_storeu_ps(p, v)
+#define VISTORE(p, v)  _mm256_storeu_si256((ivec*)(p), v)
+#define VADD(a, b)     _mm256_add_ps(a, b)
+#define VSUB(a, b)     _mm256_sub_ps(a, b)
+#define VMUL(a, b)     _mm256_mul_ps(a, b)
+#define VDIV(a, b)     _mm256_div_ps(a, b)
+#define VAND(a, b)     _mm256_and_ps(a, b)
+#define VANDNOT(a, b)  _mm256_andnot_ps(a, b)
+#define VXOR(a, b)     _mm256_xor_ps(a, b)
+#define VFLOOR(a)      _mm256_floor_ps(a)
+#define VCEIL(a)       _mm256_ceil_ps(a)
+#define VTOINT(a)      _mm256_cvttps_epi32(a)
+#define VTOFLOAT(a)    _mm256_cvtepi32_ps(a)
+#define VNOTLESS(a, b) _mm256_cmp_ps(a, b, _CMP_NLT_UQ)
+#define VMASK(a)       _mm256_movemask_ps(a)
+#else
+	const int LANES = 4;
+	typedef __m128 vec;
+	typedef __m128i ivec;
+#define VSET1(v)       _mm_set1_ps(v)
+#define VLOAD(p)       _mm_loadu_ps(p)
+#define VSTORE(p, v)   _mm_storeu_ps(p, v)
+#define VISTORE(p, v)  _mm_storeu_si128((ivec*)(p), v)
+#define VADD(a, b)     _mm_add_ps(a, b)
+#define VSUB(a, b)     _mm_sub_ps(a, b)
+#define VMUL(a, b)     _mm_mul_ps(a, b)
+#define VDIV(a, b)     _mm_div_ps(a, b)
+#define VAND(a, b)     _mm_and_ps(a, b)
+#define VANDNOT(a, b)  _mm_andnot_ps(a, b)
+#define VXOR(a, b)     _mm_xor_ps(a, b)
+#define VFLOOR(a)      _mm_floor_ps(a)
+#define VCEIL(a)       _mm_ceil_ps(a)
+#define VTOINT(a)      _mm_cvttps_epi32(a)
+#define VTOFLOAT(a)    _mm_cvtepi32_ps(a)
+#define VNOTLESS(a, b) _mm_cmpnlt_ps(a, b)
+#define VMASK(a)       _mm_movemask_ps(a)
+#endif
+
+	const vec half = VSET1(m_tile_size / 2);
+	const vec tile_size = VSET1(m_tile_size);
+	const vec left = VSET1(m_left_bound), right = VSET1(m_right_bound);
+	const vec top = VSET1(m_top_bound), bottom = VSET1(m_bottom_bound);
+	const vec sign = VSET1(-0.0f);
+
+	int   tile_x[LANES], tile_y[LANES];
+	float lane_penetration_x[LANES], lane_penetration_y[LANES];
+
+	for (; i + LANES <= count; i += LANES)
+	{
+		vec px = VLOAD(x + i);
+		vec py = VLOAD(y + i);
+
+		// !(x < left || x > right || y > top || y < bottom), NaN behaves like the scalar compares
+		vec in_bounds = VAND(VAND(VNOTLESS(px, left), VNOTLESS(right, px)),
+			VAND(VNOTLESS(top, py), VNOTLESS(py, bottom)));
+		int mask = VMASK(in_bounds);
+
+		ivec tx = VTOINT(VFLOOR(VDIV(VADD(px, half), tile_size)));
+		ivec ty = VTOINT(VDIV(VXOR(VCEIL(VSUB(py, half)), sign), tile_size)); // Our array counts up as Y goes down.
+
+		vec center_x = VMUL(VTOFLOAT(tx), tile_size);
+		vec center_y = VXOR(VMUL(VTOFLOAT(ty), tile_size), sign);
+
+		VISTORE(tile_x, tx);
+		VISTORE(tile_y, ty);
+		VSTORE(lane_penetration_x, VSUB(half, VANDNOT(sign, VSUB(px, center_x))));
+		VSTORE(lane_penetration_y, VSUB(half, VANDNOT(sign, VSUB(py, center_y))));
+
+		for (int lane = 0; lane < LANES; lane++)
+		{
+			bool hit = ((mask >> lane) & 1)
+				&& tile_x[lane] >= 0 && tile_x[lane] < m_width
+				&& tile_y[lane] >= 0 && tile_y[lane] < m_height
+				&& is_solid_tile(tile_x[lane], tile_y[lane]);
+
+			solid[i + lane] = hit;
+			penetration_x[i + lane] = hit ? lane_penetration_x[lane] : 0.0f;
+			penetration_y[i + lane] = hit ? lane_penetration_y[lane] : 0.0f;
+		}
+	}
+
+#undef VSET1
+#undef VLOAD
+#undef VSTORE
+#undef VISTORE
+#undef VADD
+#undef VSUB
+#undef VMUL
+#undef VDIV
+#undef VAND
+#undef VANDNOT
+#undef VXOR
+#undef VFLOOR
+#undef VCEIL
+#undef VTOINT
+#undef VTOFLOAT
+#undef VNOTLESS
+#undef VMASK
+#endif
+
+	// scalar fallback and leftover points
+	for (; i < count; i++)
+	{
+		solid[i] = is_solid(glm::vec3(x[i], y[i], 0.0f), &penetration_x[i], &penetration_y[i]);
+	}
+}
+
+/*
+* Swept AABB against the tile map
+* Steps from tile boundary to tile boundary along the box's path (DDA), in time
+* order, and checks the column or row of tiles the leading edge enters
+* Tiles the box already overlaps at the start are ignored -- is_solid handles those
+*
+* @param position, centre of the box at the start of the move
+* @param width, width of the box
+* @param height, height of the box
+* @param displacement, how far the box moves this step
+* @param time_of_impact, fraction of the displacement travelled before the hit, 0 to 1
+* @param normal, the face that was hit, pointing back out of the tile
+*
+* @return true when the box hits a solid tile before the end of the move
+*/
+bool Map::sweep(glm::vec3 position, float width, float height, glm::vec3 displacement,
+	float* time_of_impact, glm::vec3* normal) const
+{
+	*time_of_impact = 1.0f;
+	*normal = glm::vec3(0.0f);
+
+	if (displacement.x == 0.0f && displacement.y == 0.0f) return false;
+
+	float half = m_tile_size / 2;
+
+	// box edges in tile units -- column c spans [c, c + 1), row r spans [r, r + 1)
+	// rows count up as Y goes down, same as m_level_data
+	float left = (position.x - (width / 2) + half) / m_tile_size;
+	float right = (position.x + (width / 2) + half) / m_tile_size;
+	float top = (-(position.y + (height / 2)) + half) / m_tile_size;
+	float bottom = (-(position.y - (height / 2)) + half) / m_tile_size;
+
+	float move_x = displacement.x / m_tile_size;
+	float move_y = -displacement.y / m_tile_size;
+
+	// next column / row boundary the leading edge reaches, and when
+	int   step_x = move_x > 0.0f ? 1 : -1;
+	int   step_y = move_y > 0.0f ? 1 : -1;
+	int   column = move_x > 0.0f ? (int)ceil(right) : (int)floor(left) - 1;
+	int   row = move_y > 0.0f ? (int)ceil(bottom) : (int)floor(top) - 1;
+	float next_x = move_x != 0.0f ? ((move_x > 0.0f ? (float)column - right : left - (float)(column + 1)) / fabs(move_x)) : 2.0f;
+	float next_y = move_y != 0.0f ? ((move_y > 0.0f ? (float)row - bottom : top - (float)(row + 1)) / fabs(move_y)) : 2.0f;
+	float delta_x = move_x != 0.0f ? 1.0f / fabs(move_x) : 2.0f;
+	float delta_y = move_y != 0.0f ? 1.0f / fabs(move_y) : 2.0f;
+
+	while (next_x <= 1.0f || next_y <= 1.0f)
+	{
+		if (next_x <= next_y)
+		{
+			// leading edge enters a new column -- check every row the box spans at that time
+			float t = next_x;
+			int row_begin = (int)floor(top + move_y * t);
+			int row_end = (int)ceil(bottom + move_y * t) - 1;
+			if (column >= 0 && column < m_width)
+			{
+				for (int r = std::max(row_begin, 0); r <= std::min(row_end, m_height - 1); r++)
+				{
+					if (is_solid_tile(column, r))
+					{
+						*time_of_impact = t;
+						*normal = glm::vec3((float)-step_x, 0.0f, 0.0f);
+						return true;
+					}
+				}
+			}
+			// exact corner -- the row is entered at the same time, and neither span covers
+			// the tile in the new column and the new row, so check it here
+			if (next_y == t)
+			{
+				int column_begin = (int)floor(left + move_x * t);
+				int column_end = (int)ceil(right + move_x * t) - 1;
+				if (row >= 0 && row < m_height)
+				{
+					for (int c = std::max(column_begin, 0); c <= std::min(column_end, m_width - 1); c++)
+					{
+						if (is_solid_tile(c, row))
+						{
+							*time_of_impact = t;
+							*normal = glm::vec3(0.0f, (float)step_y, 0.0f);
+							return true;
+						}
+					}
+
+					// only the corner tile itself -- land on it rather than stop against it
+					if (column >= 0 && column < m_width && is_solid_tile(column, row))
+					{
+						*time_of_impact = t;
+						*normal = glm::vec3(0.0f, (float)step_y, 0.0f);
+						return true;
+					}
+				}
+				row += step_y;
+				next_y += delta_y;
+			}
+			column += step_x;
+			next_x += delta_x;
+		}
+		else
+		{
+			// leading edge enters a new row -- check every column the box spans at that time
+			float t = next_y;
+			int column_begin = (int)floor(left + move_x * t);
+			int column_end = (int)ceil(right + move_x * t) - 1;
+			if (row >= 0 && row < m_height)
+			{
+				for (int c = std::max(column_begin, 0); c <= std::min(column_end, m_width - 1); c++)
+				{
+					if (is_solid_tile(c, row))
+					{
+						*time_of_impact = t;
+						*normal = glm::vec3(0.0f, (float)step_y, 0.0f); // +row is down, so the normal flips
+						return true;
+					}
+				}
+			}
+			row += step_y;
+			next_y += delta_y;
+		}
+	}
+
+	return false;
+}
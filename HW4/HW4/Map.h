@@ -1,17 +1,42 @@
 #pragma once
-#define GL_SILENCE_DEPRECATION
-#ifdef _WINDOWS
-#include <GL/glew.h>
-#endif
-#define GL_GLEXT_PROTOTYPES 1
 #include <vector>
 #include <math.h>
-#include <SDL.h>
-#include <SDL_opengl.h>
-#include <SDL_image.h>
+#include <stdint.h>
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
-#include "ShaderProgram.h"
+
+class ShaderProgram;
+
+// tiles along each side of a chunk -- 32 keeps a chunk's corners within 16-bit indices
+#define MAP_CHUNK_SIZE 32
+
+// a rectangle of tiles merged into one -- tile units, rows counting down from the top
+struct TileRect
+{
+	int x, y;          // top left tile
+	int width, height; // in tiles
+	unsigned int tile; // tile set position every tile in it shares -- 0 when only solidity was merged
+};
+
+// a square block of the tile mesh with its own GPU buffer -- render() skips the ones off screen
+struct MapChunk
+{
+	unsigned int vertex_buffer = 0; // GL buffer name, 0 when the chunk has no tiles
+	int quad_count = 0;
+	int capacity = 0;   // quads the buffer has room for before it must grow
+
+	// world space edges of the chunk
+	float left, right, top, bottom;
+};
+
+// world space rectangle a camera sees
+struct ViewRect
+{
+	float left, right, top, bottom;
+};
+
+// defined in MapRender.cpp -- shared by every map renderer
+ViewRect camera_view_rect(glm::mat4 const& view_matrix, glm::mat4 const& projection_matrix);
 
 class Map
 {
@@ -19,41 +44,97 @@ private:
 	int m_width;
 	int m_height;
 
-	// array that holds tile set positions
-	unsigned int* m_level_data;
-	GLuint m_texture_id; // tile set texture
+	// array that holds tile set positions -- the map's own copy, so set_tile never
+	// touches the level it was made from or another world's map
+	std::vector<unsigned int> m_level_data;
+	unsigned int m_texture_id; // tile set texture -- GL name, only used by the renderer
 
 	float m_tile_size;
 	int   m_tile_count_x;
 	int   m_tile_count_y;
 
-	std::vector<float> m_vertices;
-	std::vector<float> m_texture_coordinates;
+	// one bit per tile, set when the tile isn't empty -- built by the constructor
+	std::vector<uint64_t> m_solid_bits;
+
+	// solid tiles merged into rectangles, one list per chunk row by row -- the
+	// broadphase for query_solid_rects, kept up to date by set_tile
+	std::vector<std::vector<TileRect>> m_solid_rects;
+	int m_solid_rect_count = 0;
+
+	// dirty-region list -- tiles set_tile changed since the mesh last caught up,
+	// each listed once however often it changed
+	std::vector<int>      m_dirty_tiles;
+	std::vector<uint64_t> m_dirty_bits;
+
+	// chunks across and down -- shared by the collision rectangles and the mesh
+	int m_chunk_count_x;
+	int m_chunk_count_y;
+
+	// tile mesh in GPU memory, one entry per chunk row by row -- filled once by build()
+	std::vector<MapChunk> m_chunks;
+	unsigned int m_index_buffer = 0; // shared by every chunk
+	int m_chunks_drawn = 0;
 
 	// map boundaries
 	float m_left_bound, m_right_bound, m_top_bound, m_bottom_bound;
 public:
 	// default constructor override
-	Map(int width, int height, unsigned int* level_data, GLuint texture_id, float tile_size, int
+	Map(int width, int height, unsigned int* level_data, unsigned int texture_id, float tile_size, int
 		tile_count_x, int tile_count_y);
 
+	// takes the tiles over instead of copying them -- for generated levels too big to hold twice
+	Map(int width, int height, std::vector<unsigned int>&& level_data, unsigned int texture_id, float tile_size,
+		int tile_count_x, int tile_count_y);
+
+	// rendering -- defined in MapRender.cpp, not part of the simulation library
 	void build();
-	void render(ShaderProgram* program);
-	bool is_solid(glm::vec3 position, float* penetration_x, float* penetration_y);
+	void render(ShaderProgram* program, glm::mat4 const& view_matrix, glm::mat4 const& projection_matrix);
+	void release_mesh();
+	void update_mesh();
+
+	void set_tile(int tile_x, int tile_y, unsigned int tile);
+	void clear_dirty_tiles();
+
+	// greedy merge of one chunk's tiles into rectangles -- identical tiles only, or any solid ones
+	void merge_tiles(int chunk_x, int chunk_y, bool match_tile, std::vector<TileRect>& rects) const;
+
+	// merged solid rectangles overlapping an AABB -- far fewer candidates than the tiles under it
+	void query_solid_rects(glm::vec3 position, float width, float height, std::vector<TileRect>& rects) const;
+
+	bool is_solid(glm::vec3 position, float* penetration_x, float* penetration_y) const;
+
+	// is_solid for count points at once -- same answers, SIMD when the build allows it
+	void is_solid_batch(const float* x, const float* y, int count,
+		bool* solid, float* penetration_x, float* penetration_y) const;
+
+	// walks the tiles an AABB passes through -- first solid tile it enters gives the hit
+	bool sweep(glm::vec3 position, float width, float height, glm::vec3 displacement,
+		float* time_of_impact, glm::vec3* normal) const;
+
+	bool is_solid_tile(int tile_x, int tile_y) const
+	{
+		int bit = tile_y * m_width + tile_x;
+		return (m_solid_bits[bit >> 6] >> (bit & 63)) & 1;
+	}
 
 	// GETTERS
 	int const get_width()  const { return m_width; }
 	int const get_height() const { return m_height; }
 
-	unsigned int* const get_level_data() const { return m_level_data; }
-	GLuint        const get_texture_id() const { return m_texture_id; }
+	const unsigned int* const get_level_data() const { return m_level_data.data(); }
+	unsigned int  const get_texture_id() const { return m_texture_id; }
 
 	float const get_tile_size()    const { return m_tile_size; }
 	int   const get_tile_count_x() const { return m_tile_count_x; }
 	int   const get_tile_count_y() const { return m_tile_count_y; }
 
-	std::vector<float> const get_vertices()            const { return m_vertices; }
-	std::vector<float> const get_texture_coordinates() const { return m_texture_coordinates; }
+	int const get_chunk_count_x() const { return m_chunk_count_x; }
+	int const get_chunk_count_y() const { return m_chunk_count_y; }
+	int const get_chunks_drawn()  const { return m_chunks_drawn; }
+	int const get_solid_rect_count() const { return m_solid_rect_count; }
+	size_t get_collision_bytes() const; // tiles, solid bits and merged rectangles -- not the GPU mesh
+
+	const std::vector<int>& get_dirty_tiles() const { return m_dirty_tiles; }
 
 	float const get_left_bound()   const { return m_left_bound; }
 	float const get_right_bound()  const { return m_right_bound; }
@@ -0,0 +1,315 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "ShaderProgram.h"
+#include "Map.h"
+#include "Profiler.h"
+#include "RenderState.h"
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// one corner of a merged quad -- matches the attributes in vertex_map.glsl
+struct MapVertex
+{
+	float x, y;
+	float u, v;        // in tiles, so the tile repeats across the quad
+	float atlas[4];    // u, v, width, height of the tile in the tile set
+};
+
+/*
+* The world space rectangle the screen covers -- the corners of clip space
+* taken back through the camera
+*
+* @param view_matrix, the camera used this frame
+* @param projection_matrix, the projection used this frame
+*/
+ViewRect camera_view_rect(glm::mat4 const& view_matrix, glm::mat4 const& projection_matrix)
+{
+	glm::mat4 clip_to_world = glm::inverse(projection_matrix * view_matrix);
+	ViewRect view = { INFINITY, -INFINITY, -INFINITY, INFINITY };
+	for (int corner = 0; corner < 4; corner++)
+	{
+		glm::vec4 world = clip_to_world * glm::vec4(corner & 1 ? 1.0f : -1.0f, corner & 2 ? 1.0f : -1.0f, 0.0f, 1.0f);
+		view.left = std::min(view.left, world.x / world.w);
+		view.right = std::max(view.right, world.x / world.w);
+		view.bottom = std::min(view.bottom, world.y / world.w);
+		view.top = std::max(view.top, world.y / world.w);
+	}
+	return view;
+}
+
+/*
+* Greedy meshes one chunk into quads, one per run of identical tiles
+*
+* @param map, the level the chunk belongs to
+* @param chunk_x, chunk_y, which chunk
+* @param rects, scratch for the merged rectangles
+* @param vertices, cleared and filled with four corners per quad
+*/
+static void chunk_vertices(const Map& map, int chunk_x, int chunk_y, std::vector<TileRect>& rects,
+	std::vector<MapVertex>& vertices)
+{
+	map.merge_tiles(chunk_x, chunk_y, true, rects);
+
+	float tile_size = map.get_tile_size();
+	int tile_count_x = map.get_tile_count_x();
+	int tile_count_y = map.get_tile_count_y();
+
+	// dimensions of each tile in the tile set
+	float tile_width = 1.0f / (float)tile_count_x;
+	float tile_height = 1.0f / (float)tile_count_y;
+
+	// get radius
+	float x_offset = -(tile_size / 2);
+	float y_offset = (tile_size / 2);
+
+	vertices.clear();
+	for (const TileRect& rect : rects)
+	{
+		float u_coord = (float)(rect.tile % tile_count_x) / (float)tile_count_x;
+		float v_coord = (float)(rect.tile / tile_count_x) / (float)tile_count_y;
+
+		float left = x_offset + (tile_size * rect.x);
+		float top = y_offset + -tile_size * rect.y;
+		float right = left + tile_size * rect.width;
+		float bottom = top - tile_size * rect.height;
+		float across = (float)rect.width;
+		float down = (float)rect.height;
+
+		// top left, bottom left, bottom right, top right
+		vertices.push_back({ left,  top,    0.0f,   0.0f, { u_coord, v_coord, tile_width, tile_height } });
+		vertices.push_back({ left,  bottom, 0.0f,   down, { u_coord, v_coord, tile_width, tile_height } });
+		vertices.push_back({ right, bottom, across, down, { u_coord, v_coord, tile_width, tile_height } });
+		vertices.push_back({ right, top,    across, 0.0f, { u_coord, v_coord, tile_width, tile_height } });
+	}
+}
+
+/*
+* Sends a chunk's quads to its buffer, growing the buffer if they don't fit
+*
+* @param chunk, the chunk to fill
+* @param vertices, four corners per quad from chunk_vertices
+* @param spare, leave room to grow -- chunks that have been edited once tend to be edited again
+*/
+static void upload_chunk(MapChunk& chunk, const std::vector<MapVertex>& vertices, bool spare)
+{
+	chunk.quad_count = (int)vertices.size() / 4;
+
+	if (chunk.quad_count > chunk.capacity)
+	{
+		chunk.capacity = spare ? std::min(std::max(chunk.quad_count * 2, 64), MAP_CHUNK_SIZE * MAP_CHUNK_SIZE) : chunk.quad_count;
+		if (chunk.vertex_buffer == 0) glGenBuffers(1, &chunk.vertex_buffer);
+
+		glBindBuffer(GL_ARRAY_BUFFER, chunk.vertex_buffer);
+		glBufferData(GL_ARRAY_BUFFER, (size_t)chunk.capacity * 4 * sizeof(MapVertex), nullptr, GL_STATIC_DRAW);
+	}
+	else glBindBuffer(GL_ARRAY_BUFFER, chunk.vertex_buffer);
+
+	if (chunk.quad_count > 0) glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(MapVertex), vertices.data());
+}
+
+/*
+* Builds the tile mesh chunk by chunk and uploads it to the GPU once -- render()
+* then draws straight from the buffers, so nothing crosses the bus per frame.
+* Runs of identical tiles become one quad with the tile repeated across it
+* Kept out of Map.cpp so the simulation library has no GL dependency
+*/
+void Map::build()
+{
+	PROFILE_SCOPE("Map::build");
+	// rebuilding replaces the old mesh rather than appending to it
+	release_mesh();
+	clear_dirty_tiles();
+
+	m_chunks.resize((size_t)m_chunk_count_x * m_chunk_count_y);
+
+	// reused for every chunk, only lives until the upload
+	std::vector<TileRect> rects;
+	std::vector<MapVertex> vertices;
+
+	for (int chunk_y = 0; chunk_y < m_chunk_count_y; chunk_y++)
+	{
+		for (int chunk_x = 0; chunk_x < m_chunk_count_x; chunk_x++)
+		{
+			MapChunk& chunk = m_chunks[chunk_y * m_chunk_count_x + chunk_x];
+
+			int first_x = chunk_x * MAP_CHUNK_SIZE;
+			int first_y = chunk_y * MAP_CHUNK_SIZE;
+			int last_x = std::min(first_x + MAP_CHUNK_SIZE, m_width);
+			int last_y = std::min(first_y + MAP_CHUNK_SIZE, m_height);
+
+			chunk.left = -(m_tile_size / 2) + m_tile_size * first_x;
+			chunk.right = -(m_tile_size / 2) + m_tile_size * last_x;
+			chunk.top = (m_tile_size / 2) - m_tile_size * first_y;
+			chunk.bottom = (m_tile_size / 2) - m_tile_size * last_y;
+
+			chunk_vertices(*this, chunk_x, chunk_y, rects, vertices);
+			if (!vertices.empty()) upload_chunk(chunk, vertices, false);
+		}
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// every chunk lays its quads out the same way, so one index buffer serves them all
+	std::vector<GLushort> indices;
+	indices.reserve(MAP_CHUNK_SIZE * MAP_CHUNK_SIZE * 6);
+	for (int i = 0; i < MAP_CHUNK_SIZE * MAP_CHUNK_SIZE; i++)
+	{
+		GLushort first = (GLushort)(i * 4);
+
+		// same two triangles the old six-vertex layout drew
+		indices.insert(indices.end(), {
+			first, (GLushort)(first + 1), (GLushort)(first + 2),
+			first, (GLushort)(first + 2), (GLushort)(first + 3)
+		});
+	}
+
+	glGenBuffers(1, &m_index_buffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_index_buffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+/*
+* Brings the mesh up to date with set_tile -- every pending edit is applied at once.
+* An edit can split or join merged quads, so each chunk with an edit in it is meshed
+* again (32x32 tiles at most) and sent with one sub-range upload into its buffer.
+* Call once a frame before render()
+*/
+void Map::update_mesh()
+{
+	PROFILE_SCOPE("Map::update_mesh");
+	if (m_dirty_tiles.empty()) return;
+
+	// no mesh to patch -- build() reads the level data fresh anyway
+	if (m_chunks.empty())
+	{
+		clear_dirty_tiles();
+		return;
+	}
+
+	// each chunk once, however many of its tiles changed
+	std::vector<int> dirty_chunks;
+	dirty_chunks.reserve(m_dirty_tiles.size());
+	for (int index : m_dirty_tiles)
+	{
+		dirty_chunks.push_back(((index / m_width) / MAP_CHUNK_SIZE) * m_chunk_count_x + (index % m_width) / MAP_CHUNK_SIZE);
+	}
+	std::sort(dirty_chunks.begin(), dirty_chunks.end());
+	dirty_chunks.erase(std::unique(dirty_chunks.begin(), dirty_chunks.end()), dirty_chunks.end());
+
+	std::vector<TileRect> rects;
+	std::vector<MapVertex> vertices;
+	for (int chunk_index : dirty_chunks)
+	{
+		chunk_vertices(*this, chunk_index % m_chunk_count_x, chunk_index / m_chunk_count_x, rects, vertices);
+		upload_chunk(m_chunks[chunk_index], vertices, true);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	clear_dirty_tiles();
+}
+
+/*
+* Frees the GPU copy of the mesh -- needs a live GL context, so call it before
+* the window goes away
+*/
+void Map::release_mesh()
+{
+	PROFILE_SCOPE("Map::release_mesh");
+	for (MapChunk& chunk : m_chunks)
+	{
+		if (chunk.vertex_buffer != 0) glDeleteBuffers(1, &chunk.vertex_buffer);
+	}
+	if (m_index_buffer != 0) glDeleteBuffers(1, &m_index_buffer);
+
+	m_chunks.clear();
+	m_index_buffer = 0;
+}
+
+/*
+* Draws the chunks that overlap the camera -- only the chunk range under the
+* view is visited, so the cost follows the screen size rather than the level size
+*
+* @param program, the SHADERPROGRAM loaded from the map shaders
+* @param view_matrix, the camera used this frame
+* @param projection_matrix, the projection used this frame
+*/
+void Map::render(ShaderProgram* program, glm::mat4 const& view_matrix, glm::mat4 const& projection_matrix)
+{
+	PROFILE_SCOPE("Map::render");
+	m_chunks_drawn = 0;
+	if (m_chunks.empty()) return;
+
+	ViewRect view = camera_view_rect(view_matrix, projection_matrix);
+
+	// chunk range under the view -- rows grow downwards from the top of the map
+	float chunk_extent = m_tile_size * MAP_CHUNK_SIZE;
+	float map_left = -(m_tile_size / 2);
+	float map_top = (m_tile_size / 2);
+
+	int first_x = std::max((int)floorf((view.left - map_left) / chunk_extent), 0);
+	int last_x = std::min((int)floorf((view.right - map_left) / chunk_extent), m_chunk_count_x - 1);
+	int first_y = std::max((int)floorf((map_top - view.top) / chunk_extent), 0);
+	int last_y = std::min((int)floorf((map_top - view.bottom) / chunk_extent), m_chunk_count_y - 1);
+	if (first_x > last_x || first_y > last_y) return;
+
+	g_render_state.use_program(program->get_program_id());
+	program->set_view_matrix(view_matrix);
+	program->set_projection_matrix(projection_matrix);
+
+	// tileAtlas isn't in the entity shader -- nothing else may be left on
+	GLuint position_attribute = program->get_position_attribute();
+	GLuint tex_coord_attribute = program->get_tex_coordinate_attribute();
+	GLuint atlas_attribute = program->get_attribute_location("tileAtlas");
+	g_render_state.disable_other_attributes(RenderState::attribute_bit(position_attribute)
+		| RenderState::attribute_bit(tex_coord_attribute) | RenderState::attribute_bit(atlas_attribute));
+	g_render_state.enable_attribute(position_attribute);
+	g_render_state.enable_attribute(tex_coord_attribute);
+	g_render_state.enable_attribute(atlas_attribute);
+	g_render_state.bind_texture(m_texture_id);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_index_buffer);
+
+	for (int chunk_y = first_y; chunk_y <= last_y; chunk_y++)
+	{
+		for (int chunk_x = first_x; chunk_x <= last_x; chunk_x++)
+		{
+			const MapChunk& chunk = m_chunks[chunk_y * m_chunk_count_x + chunk_x];
+			if (chunk.quad_count == 0) continue;
+
+			// edge chunks of the range can still miss the view
+			if (chunk.right < view.left || chunk.left > view.right ||
+				chunk.top < view.bottom || chunk.bottom > view.top) continue;
+
+			glBindBuffer(GL_ARRAY_BUFFER, chunk.vertex_buffer);
+			glVertexAttribPointer(position_attribute, 2, GL_FLOAT, false, sizeof(MapVertex), (void*)offsetof(MapVertex, x));
+			glVertexAttribPointer(tex_coord_attribute, 2, GL_FLOAT, false, sizeof(MapVertex), (void*)offsetof(MapVertex, u));
+			glVertexAttribPointer(atlas_attribute, 4, GL_FLOAT, false, sizeof(MapVertex), (void*)offsetof(MapVertex, atlas));
+
+			glDrawElements(GL_TRIANGLES, chunk.quad_count * 6, GL_UNSIGNED_SHORT, 0);
+			m_chunks_drawn++;
+		}
+	}
+
+	// Entity::render and TilemapRenderer::render still pass client-side arrays, and know nothing of tileAtlas
+	g_render_state.disable_attribute(atlas_attribute);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,145 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include "Profiler.h"
+
+#ifdef HW4_PROFILE
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct ProfileEvent
+{
+	const char* name;
+	uint64_t start_ns;
+	uint64_t duration_ns;
+};
+
+/*
+* One thread's events -- only that thread writes them
+* count goes up after the event is stored, so a dump never reads a half written
+* slot unless the ring wraps underneath it
+*/
+struct ProfileRing
+{
+	ProfileEvent events[PROFILE_RING_SIZE];
+	std::atomic<uint64_t> count{ 0 };
+	int thread_id = 0;
+	std::string thread_name;
+};
+
+static const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+
+// rings are never freed, so a worker's events can still be dumped after it exits
+static std::mutex s_ring_mutex;
+static std::vector<ProfileRing*> s_rings;
+static thread_local ProfileRing* t_ring = nullptr;
+
+/*
+* The calling thread's ring, made on its first event
+*/
+static ProfileRing* this_thread_ring()
+{
+	if (t_ring != nullptr) return t_ring;
+
+	ProfileRing* ring = new ProfileRing();
+	std::lock_guard<std::mutex> lock(s_ring_mutex);
+	ring->thread_id = (int)s_rings.size();
+	ring->thread_name = "thread " + std::to_string(ring->thread_id);
+	s_rings.push_back(ring);
+	t_ring = ring;
+	return ring;
+}
+
+// nanoseconds since the program started
+uint64_t profile_now()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_epoch).count();
+}
+
+/*
+* Stores one finished scope in the calling thread's ring
+*
+* @param name, a string literal naming the scope
+* @param start_ns, profile_now() when the scope began
+*/
+void profile_record(const char* name, uint64_t start_ns)
+{
+	uint64_t end_ns = profile_now();
+	ProfileRing* ring = this_thread_ring();
+
+	uint64_t count = ring->count.load(std::memory_order_relaxed);
+	ProfileEvent& event = ring->events[count & (PROFILE_RING_SIZE - 1)];
+	event.name = name;
+	event.start_ns = start_ns;
+	event.duration_ns = end_ns - start_ns;
+	ring->count.store(count + 1, std::memory_order_release);
+}
+
+/*
+* Labels the calling thread in the trace
+*
+* @param name, shown instead of "thread N"
+*/
+void profile_name_thread(const char* name)
+{
+	ProfileRing* ring = this_thread_ring();
+	std::lock_guard<std::mutex> lock(s_ring_mutex);
+	ring->thread_name = name;
+}
+
+/*
+* Writes every thread's recorded scopes as Chrome trace_event JSON
+* Best called between frames -- a thread still recording can overwrite its
+* oldest events while they are being written out
+*
+* @param filepath, where to write the trace
+*
+* @return false if the file can't be written
+*/
+bool write_profile_trace(const char* filepath)
+{
+	std::ofstream file(filepath);
+	if (!file) return false;
+
+	file << std::fixed << std::setprecision(3);
+	file << "{\"traceEvents\":[\n";
+
+	std::lock_guard<std::mutex> lock(s_ring_mutex);
+	bool first = true;
+	for (ProfileRing* ring : s_rings)
+	{
+		if (!first) file << ",\n";
+		first = false;
+		file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->thread_id
+			<< ",\"args\":{\"name\":\"" << ring->thread_name << "\"}}";
+
+		uint64_t count = ring->count.load(std::memory_order_acquire);
+		uint64_t oldest = count > (uint64_t)PROFILE_RING_SIZE ? count - PROFILE_RING_SIZE : 0;
+		for (uint64_t i = oldest; i < count; i++)
+		{
+			const ProfileEvent& event = ring->events[i & (PROFILE_RING_SIZE - 1)];
+
+			// chrome wants microseconds
+			file << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->thread_id
+				<< ",\"ts\":" << event.start_ns / 1000.0 << ",\"dur\":" << event.duration_ns / 1000.0 << "}";
+		}
+	}
+
+	file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return file.good();
+}
+
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+
+/*
+* Scoped CPU timers -- PROFILE_SCOPE("name") times the rest of the enclosing block
+* Every thread records into its own ring, so timing a scope never takes a lock,
+* and write_profile_trace() dumps all the rings as Chrome trace_event JSON
+* (open it in chrome://tracing or ui.perfetto.dev)
+*
+* Compiled out unless HW4_PROFILE is defined -- the macros then expand to nothing
+*/
+
+// events each thread keeps, the oldest are overwritten once it wraps -- power of two
+const int PROFILE_RING_SIZE = 1 << 16;
+
+#ifdef HW4_PROFILE
+
+// only the pointer is kept, so names must be string literals
+void profile_record(const char* name, uint64_t start_ns);
+uint64_t profile_now();
+
+class ProfileScope
+{
+private:
+	const char* m_name;
+	uint64_t m_start;
+
+public:
+	ProfileScope(const char* name) : m_name(name), m_start(profile_now()) {}
+	~ProfileScope() { profile_record(m_name, m_start); }
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+
+void profile_name_thread(const char* name);
+bool write_profile_trace(const char* filepath);
+
+#else
+
+#define PROFILE_SCOPE(name)
+
+inline void profile_name_thread(const char*) {}
+inline bool write_profile_trace(const char*) { return false; }
+
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+#include <stdint.h>
+
+/*
+* Small seeded random number stream (PCG32)
+* Every world owns one, so worlds never share state and the same seed
+* always gives the same sequence on any machine or thread
+*/
+struct Random
+{
+	uint64_t state = 0x853c49e6748fea9bULL;
+
+	void seed(uint64_t seed)
+	{
+		state = 0;
+		next();
+		state += seed;
+		next();
+	}
+
+	uint32_t next()
+	{
+		uint64_t old = state;
+		state = old * 6364136223846793005ULL + 1442695040888963407ULL;
+		uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+		uint32_t rotation = (uint32_t)(old >> 59u);
+		return (xorshifted >> rotation) | (xorshifted << ((0u - rotation) & 31u));
+	}
+
+	// 0 to count - 1
+	int range(int count) { return (int)(next() % (uint32_t)count); }
+};
@@ -0,0 +1,127 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include "RenderState.h"
+
+RenderState g_render_state;
+
+void RenderState::use_program(GLuint program_id)
+{
+	if (m_program == program_id)
+	{
+		m_skipped++;
+		return;
+	}
+
+	glUseProgram(program_id);
+	m_program = program_id;
+	m_issued++;
+}
+
+void RenderState::bind_texture(GLuint texture_id)
+{
+	if (m_texture == texture_id)
+	{
+		m_skipped++;
+		return;
+	}
+
+	glBindTexture(GL_TEXTURE_2D, texture_id);
+	m_texture = texture_id;
+	m_issued++;
+}
+
+/*
+* Attributes are left enabled between draws -- every draw sets both
+* attribute pointers first, so there's nothing stale for it to read
+*
+* @param attribute, location from the SHADERPROGRAM -- the first 32 are tracked
+*/
+void RenderState::enable_attribute(GLuint attribute)
+{
+	uint32_t bit = attribute_bit(attribute);
+	if (bit != 0 && (m_known_attributes & bit) && (m_enabled_attributes & bit))
+	{
+		m_skipped++;
+		return;
+	}
+
+	glEnableVertexAttribArray(attribute);
+	m_known_attributes |= bit;
+	m_enabled_attributes |= bit;
+	m_issued++;
+}
+
+void RenderState::disable_attribute(GLuint attribute)
+{
+	uint32_t bit = attribute_bit(attribute);
+	if (bit != 0 && (m_known_attributes & bit) && !(m_enabled_attributes & bit))
+	{
+		m_skipped++;
+		return;
+	}
+
+	glDisableVertexAttribArray(attribute);
+	m_known_attributes |= bit;
+	m_enabled_attributes &= ~bit;
+	m_issued++;
+}
+
+// mask of the attribute locations GL_MAX_VERTEX_ATTRIBS allows, up to the 32 tracked
+uint32_t RenderState::attribute_slots()
+{
+	if (m_attribute_slots == 0)
+	{
+		GLint count = 0;
+		glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &count);
+		m_attribute_slots = count >= 32 ? 0xffffffffu : (1u << (count > 0 ? count : 16)) - 1;
+	}
+	return m_attribute_slots;
+}
+
+/*
+* Turns off every enabled attribute outside a mask -- for switching to a
+* shader whose attribute locations may overlap the last one's
+* Attributes the shadow doesn't know about may be enabled, so they're turned off too
+*
+* @param keep, attribute_bit of each location to leave alone
+*/
+void RenderState::disable_other_attributes(uint32_t keep)
+{
+	uint32_t unknown = attribute_slots() & ~m_known_attributes;
+	uint32_t enabled = (m_enabled_attributes | unknown) & ~keep;
+	for (GLuint attribute = 0; enabled != 0; attribute++, enabled >>= 1)
+	{
+		if (enabled & 1) disable_attribute(attribute);
+	}
+}
+
+// forgotten attributes count as possibly enabled until they're set again
+void RenderState::invalidate()
+{
+	m_program = UNKNOWN;
+	m_texture = UNKNOWN;
+	m_known_attributes = 0;
+	m_enabled_attributes = 0;
+}
+
+// closes the counters for the frame just drawn
+void RenderState::begin_frame()
+{
+	m_last_issued = m_issued;
+	m_last_skipped = m_skipped;
+	m_total_issued += m_issued;
+	m_total_skipped += m_skipped;
+	m_issued = 0;
+	m_skipped = 0;
+	m_frame_count++;
+}
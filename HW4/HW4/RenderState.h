@@ -0,0 +1,70 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <stdint.h>
+
+/*
+* Shadow copy of the GL state the game changes -- bound program, bound
+* texture and enabled vertex attributes. Calls that wouldn't change anything
+* are dropped. Uniform values are shadowed by each SHADERPROGRAM, which
+* reports to the same counters
+*
+* Everything that draws goes through the one g_render_state, so the shadow
+* matches GL as long as nothing calls these GL functions directly
+*/
+class RenderState
+{
+private:
+	static const GLuint UNKNOWN = 0xffffffff; // forces the first call through
+
+	GLuint   m_program = UNKNOWN;
+	GLuint   m_texture = UNKNOWN;
+	uint32_t m_enabled_attributes = 0;
+	uint32_t m_known_attributes = 0; // attributes whose state has been set at least once
+	uint32_t m_attribute_slots = 0;  // a bit for every location GL has, filled in on first use
+
+	uint32_t attribute_slots();
+
+	// this frame, last frame and since startup
+	int  m_issued = 0;
+	int  m_skipped = 0;
+	int  m_last_issued = 0;
+	int  m_last_skipped = 0;
+	long m_total_issued = 0;
+	long m_total_skipped = 0;
+	long m_frame_count = 0;
+
+public:
+	void use_program(GLuint program_id);
+	void bind_texture(GLuint texture_id);
+	void enable_attribute(GLuint attribute);
+	void disable_attribute(GLuint attribute);
+	void disable_other_attributes(uint32_t keep);
+
+	// mask bit for an attribute location -- locations past 31 aren't tracked
+	static uint32_t attribute_bit(GLuint attribute) { return attribute < 32 ? 1u << attribute : 0; };
+
+	// GL deletes bound names silently -- keep the shadow in step
+	void forget_texture(GLuint texture_id) { if (m_texture == texture_id) m_texture = UNKNOWN; };
+	// call after anything changes GL state behind the tracker's back
+	void invalidate();
+
+	void begin_frame();
+
+	// for state set elsewhere, e.g. uniforms in SHADERPROGRAM
+	void count_issued()  { m_issued++; };
+	void count_skipped() { m_skipped++; };
+
+	// GETTERS -- last full frame
+	int  const get_issued_calls()  const { return m_last_issued; };
+	int  const get_skipped_calls() const { return m_last_skipped; };
+	long const get_total_issued()  const { return m_total_issued + m_issued; };
+	long const get_total_skipped() const { return m_total_skipped + m_skipped; };
+	long const get_frame_count()   const { return m_frame_count; };
+};
+
+extern RenderState g_render_state;
@@ -1,6 +1,8 @@
 #define GL_SILENCE_DEPRECATION
 
 #include "ShaderProgram.h"
+#include "AssetArchive.h"
+#include "RenderState.h"
 
 void ShaderProgram::load(const char* vertex_shader_file, const char* fragment_shader_file) {
 
@@ -31,6 +33,9 @@ void ShaderProgram::load(const char* vertex_shader_file, const char* fragment_sh
     m_position_attribute = glGetAttribLocation(m_program_id, "position");
     m_tex_coord_attribute = glGetAttribLocation(m_program_id, "texCoord");
 
+    // new program -- nothing uploaded to it yet
+    m_model_matrix_set = m_view_matrix_set = m_projection_matrix_set = m_colour_set = false;
+
     set_colour(1.0f, 1.0f, 1.0f, 1.0f);
 
 }
@@ -44,6 +49,14 @@ void ShaderProgram::cleanup()
 
 GLuint ShaderProgram::load_shader_from_file(const std::string& shaderFile, GLenum type)
 {
+    // Use the packed copy if there is one
+    const ArchiveEntry* entry = m_archive ? m_archive->find(shaderFile.c_str()) : nullptr;
+    if (entry != nullptr && entry->type == ARCHIVE_TEXT)
+    {
+        std::string contents((const char*)m_archive->get_data(entry), (size_t)entry->size);
+        return load_shader_from_string(contents, type);
+    }
+
     //Open a file stream with the file name
     std::ifstream infile(shaderFile);
 
@@ -88,26 +101,53 @@ GLuint ShaderProgram::load_shader_from_string(const std::string& shaderContents,
     return shaderID;
 }
 
+// Uniform setters only reach GL when the value changes -- see RenderState.h
+// A skipped set doesn't bind the program, so draws must call use_program themselves
 void ShaderProgram::set_colour(float red, float green, float blue, float alpha)
 {
-    glUseProgram(m_program_id);
+    glm::vec4 colour(red, green, blue, alpha);
+    if (m_colour_set && colour == m_colour) { g_render_state.count_skipped(); return; }
+
+    g_render_state.use_program(m_program_id);
     glUniform4f(m_colour_uniform, red, green, blue, alpha);
+    g_render_state.count_issued();
+
+    m_colour = colour;
+    m_colour_set = true;
 }
 
 void ShaderProgram::set_view_matrix(const glm::mat4& matrix)
 {
-    glUseProgram(m_program_id);
+    if (m_view_matrix_set && matrix == m_view_matrix) { g_render_state.count_skipped(); return; }
+
+    g_render_state.use_program(m_program_id);
     glUniformMatrix4fv(m_view_matrix_uniform, 1, GL_FALSE, &matrix[0][0]);
+    g_render_state.count_issued();
+
+    m_view_matrix = matrix;
+    m_view_matrix_set = true;
 }
 
 void ShaderProgram::set_model_matrix(const glm::mat4& matrix)
 {
-    glUseProgram(m_program_id);
+    if (m_model_matrix_set && matrix == m_model_matrix) { g_render_state.count_skipped(); return; }
+
+    g_render_state.use_program(m_program_id);
     glUniformMatrix4fv(m_model_matrix_uniform, 1, GL_FALSE, &matrix[0][0]);
+    g_render_state.count_issued();
+
+    m_model_matrix = matrix;
+    m_model_matrix_set = true;
 }
 
 void ShaderProgram::set_projection_matrix(const glm::mat4& matrix)
 {
-    glUseProgram(m_program_id);
+    if (m_projection_matrix_set && matrix == m_projection_matrix) { g_render_state.count_skipped(); return; }
+
+    g_render_state.use_program(m_program_id);
     glUniformMatrix4fv(m_projection_matrix_uniform, 1, GL_FALSE, &matrix[0][0]);
+    g_render_state.count_issued();
+
+    m_projection_matrix = matrix;
+    m_projection_matrix_set = true;
 }
\ No newline at end of file
@@ -10,6 +10,9 @@
 #include <fstream>
 #include <sstream>
 #include "glm/mat4x4.hpp"
+#include "glm/vec4.hpp"
+
+class AssetArchive;
 
 class ShaderProgram
 {
@@ -32,6 +35,18 @@ private:
     GLuint m_vertex_shader;
     GLuint m_fragment_shader;
 
+    const AssetArchive* m_archive = nullptr; // shaders found here skip the file system
+
+    // last value uploaded to each uniform -- setting the same value again is skipped
+    glm::mat4 m_model_matrix;
+    glm::mat4 m_view_matrix;
+    glm::mat4 m_projection_matrix;
+    glm::vec4 m_colour;
+    bool m_model_matrix_set = false;
+    bool m_view_matrix_set = false;
+    bool m_projection_matrix_set = false;
+    bool m_colour_set = false;
+
 public:
 
     void load(const char* vertex_shader_file, const char* fragment_shader_file);
@@ -44,6 +59,8 @@ public:
     GLuint const get_program_id()               const { return m_program_id; };
     GLuint const get_position_attribute()       const { return m_position_attribute; };
     GLuint const get_tex_coordinate_attribute() const { return m_tex_coord_attribute; };
+    GLuint const get_attribute_location(const char* name) const { return glGetAttribLocation(m_program_id, name); };
 
     void set_program_id(GLuint program_id) { m_program_id = program_id; };
+    void set_archive(const AssetArchive* archive) { m_archive = archive; };
 };
\ No newline at end of file
@@ -0,0 +1,121 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <type_traits>
+#include "Snapshot.h"
+
+static_assert(std::is_trivially_copyable<EntitySnapshot>::value, "snapshots must copy as plain bytes");
+static_assert(std::is_trivially_copyable<SnapshotHeader>::value, "snapshots must copy as plain bytes");
+
+// player, every enemy, both weapons -- the same order hash_game_state uses
+int snapshot_entity_count(const GameState& state)
+{
+	return 1 + state.enemy_count + 2;
+}
+
+/*
+* Copies the whole GAMESTATE out
+*
+* @param state, the GAMESTATE to copy
+* @param header, receives the tick, random stream and trap
+* @param entities, receives snapshot_entity_count(state) entities
+*/
+void save_snapshot(const GameState& state, SnapshotHeader& header, EntitySnapshot* entities)
+{
+	header.tick = state.tick;
+	header.random_state = state.store->random.state;
+	header.trap_placed = state.trap_placed;
+
+	state.player->save_snapshot(*entities++);
+	for (int i = 0; i < state.enemy_count; ++i) state.enemies[i].save_snapshot(*entities++);
+	for (size_t i = 0; i < 2; ++i) state.weapons[i].save_snapshot(*entities++);
+}
+
+/*
+* Puts a GAMESTATE back exactly as save_snapshot found it
+*
+* @param state, the GAMESTATE to overwrite -- must be the one the snapshot came from
+* @param header, the tick, random stream and trap
+* @param entities, snapshot_entity_count(state) entities
+*/
+void load_snapshot(GameState& state, const SnapshotHeader& header, const EntitySnapshot* entities)
+{
+	state.tick = header.tick;
+	state.store->random.state = header.random_state;
+	state.trap_placed = header.trap_placed;
+
+	state.player->load_snapshot(*entities++);
+	for (int i = 0; i < state.enemy_count; ++i) state.enemies[i].load_snapshot(*entities++);
+	for (size_t i = 0; i < 2; ++i) state.weapons[i].load_snapshot(*entities++);
+}
+
+/*
+* Takes all the memory the ring will ever need
+*
+* @param state, the GAMESTATE that will be saved -- sets the snapshot size
+* @param capacity, how many ticks to keep -- at least 1
+*/
+SnapshotRing::SnapshotRing(const GameState& state, int capacity)
+	: m_entity_count(snapshot_entity_count(state)), m_capacity(std::max(capacity, 1)),
+	m_headers(m_capacity), m_entities((size_t)m_capacity * m_entity_count)
+{
+}
+
+/*
+* Saves the current tick, overwriting the oldest one once the ring is full
+*
+* @param state, the GAMESTATE to save
+*/
+void SnapshotRing::save(const GameState& state)
+{
+	m_newest = (m_newest + 1) % m_capacity;
+	if (m_count < m_capacity) m_count++;
+
+	save_snapshot(state, m_headers[m_newest], &m_entities[(size_t)m_newest * m_entity_count]);
+}
+
+/*
+* Rolls the GAMESTATE back to a saved tick
+* Snapshots newer than that tick are dropped, since stepping again replaces them
+*
+* @param state, the GAMESTATE to overwrite
+* @param tick, the tick to go back to
+*
+* @return false if that tick isn't in the ring -- the state is left alone
+*/
+bool SnapshotRing::restore(GameState& state, long tick)
+{
+	int slot = m_newest;
+	for (int age = 0; age < m_count; age++)
+	{
+		if (m_headers[slot].tick == tick)
+		{
+			load_snapshot(state, m_headers[slot], &m_entities[(size_t)slot * m_entity_count]);
+			m_newest = slot;
+			m_count -= age;
+			return true;
+		}
+		slot = (slot + m_capacity - 1) % m_capacity;
+	}
+	return false;
+}
+
+long const SnapshotRing::get_oldest_tick() const
+{
+	if (m_count == 0) return -1;
+	return m_headers[(m_newest + m_capacity - m_count + 1) % m_capacity].tick;
+}
+
+long const SnapshotRing::get_newest_tick() const
+{
+	if (m_count == 0) return -1;
+	return m_headers[m_newest].tick;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include "glm/vec3.hpp"
+#include "GameState.h"
+
+/*
+* Everything about one ENTITY that can change during play -- its STORE slot
+* plus its own fields. Plain data, so a snapshot is one flat copy with no
+* pointers to chase or fix up. Textures belong to the renderer and are left out
+*/
+struct EntitySnapshot
+{
+	glm::vec3 position;
+	glm::vec3 velocity;
+	glm::vec3 acceleration;
+	glm::vec3 movement;
+	float speed;
+	float width;
+	float height;
+	uint8_t flags;
+
+	float walk_speed;
+	float sprint_speed;
+	float sneak_speed;
+	float jumping_power;
+	bool continuous_collision;
+	glm::vec3 spawn_position;
+
+	EntityType  entity_type;
+	PlayerState movement_state;
+	AIType      ai_type;
+	AIState     ai_state;
+
+	bool is_facing_right;
+	bool is_dead;
+	bool is_jumping;
+	float ability_timer;
+	float ability_cooldown;
+};
+
+// the rest of the GAMESTATE -- one per snapshot
+struct SnapshotHeader
+{
+	long tick;
+	uint64_t random_state;
+	bool trap_placed;
+};
+
+int  snapshot_entity_count(const GameState& state);
+void save_snapshot(const GameState& state, SnapshotHeader& header, EntitySnapshot* entities);
+void load_snapshot(GameState& state, const SnapshotHeader& header, const EntitySnapshot* entities);
+
+/*
+* The last few ticks of a GAMESTATE, for rollback and replay scrubbing
+* All memory is taken up front -- saving overwrites the oldest snapshot and
+* never allocates
+*/
+class SnapshotRing
+{
+private:
+	int m_entity_count;
+	int m_capacity;
+
+	std::vector<SnapshotHeader> m_headers;  // one per slot
+	std::vector<EntitySnapshot> m_entities; // m_entity_count per slot, back to back
+
+	int m_newest = -1; // slot of the latest snapshot
+	int m_count = 0;
+
+public:
+	SnapshotRing(const GameState& state, int capacity);
+
+	void save(const GameState& state);
+	bool restore(GameState& state, long tick);
+	void clear() { m_newest = -1; m_count = 0; }
+
+	// GETTERS
+	int  const get_count()    const { return m_count; };
+	int  const get_capacity() const { return m_capacity; };
+	long const get_oldest_tick() const;
+	long const get_newest_tick() const;
+	size_t const get_snapshot_bytes() const { return sizeof(SnapshotHeader) + m_entity_count * sizeof(EntitySnapshot); };
+};
@@ -0,0 +1,208 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <math.h>
+#include "Entity.h"
+#include "SpatialGrid.h"
+
+// keeps the cell arrays roughly proportional to the number of entities
+const int MIN_CELLS = 64;
+const int CELLS_PER_ENTITY = 2;
+
+/*
+* SpatialGrid Constructor
+*
+* @param tile_size, the MAP's tile size -- cells are a multiple of it
+*/
+SpatialGrid::SpatialGrid(float tile_size)
+{
+	m_tile_size = tile_size;
+	m_cell_size = tile_size;
+
+	m_origin_x = 0.0f;
+	m_origin_y = 0.0f;
+	m_cells_x = 0;
+	m_cells_y = 0;
+
+	m_max_half_width = 0.0f;
+	m_max_half_height = 0.0f;
+}
+
+// clamped while still a double, so a point far outside the grid can't overflow the int
+int SpatialGrid::cell_x(float x) const
+{
+	double cell = floor(((double)x - m_origin_x) / m_cell_size);
+	return (int)std::min(std::max(cell, 0.0), (double)(m_cells_x - 1));
+}
+
+int SpatialGrid::cell_y(float y) const
+{
+	double cell = floor(((double)y - m_origin_y) / m_cell_size);
+	return (int)std::min(std::max(cell, 0.0), (double)(m_cells_y - 1));
+}
+
+/*
+* Sorts every active entity into the cell holding its centre
+* Counting sort, so entries in a cell stay in ascending index order
+*
+* @param entities, the array the query results index into
+* @param entity_count, size of the array above
+*/
+void SpatialGrid::build(Entity* entities, int entity_count)
+{
+	m_entries.clear();
+	m_entity_cell.assign(entity_count, -1);
+
+	// bounds and largest entity
+	float min_x = 0.0f, min_y = 0.0f, max_x = 0.0f, max_y = 0.0f;
+	float max_extent = 0.0f;
+	m_max_half_width = 0.0f;
+	m_max_half_height = 0.0f;
+	bool any = false;
+
+	for (int i = 0; i < entity_count; i++)
+	{
+		if (!entities[i].is_active()) continue;
+
+		glm::vec3 position = entities[i].get_position();
+		float half_width = entities[i].get_width() / 2.0f;
+		float half_height = entities[i].get_height() / 2.0f;
+
+		if (!any)
+		{
+			min_x = max_x = position.x;
+			min_y = max_y = position.y;
+			any = true;
+		}
+		min_x = std::min(min_x, position.x);
+		min_y = std::min(min_y, position.y);
+		max_x = std::max(max_x, position.x);
+		max_y = std::max(max_y, position.y);
+
+		m_max_half_width = std::max(m_max_half_width, half_width);
+		m_max_half_height = std::max(m_max_half_height, half_height);
+	}
+	max_extent = 2.0f * std::max(m_max_half_width, m_max_half_height);
+
+	// whole number of tiles, never smaller than the biggest entity
+	float tiles = std::max(1.0f, ceil(max_extent / m_tile_size));
+	m_cell_size = tiles * m_tile_size;
+	m_origin_x = min_x;
+	m_origin_y = min_y;
+
+	// counted in doubles -- very spread out entities would overflow an int before the budget check
+	double cell_budget = std::max(MIN_CELLS, CELLS_PER_ENTITY * entity_count);
+	for (;;)
+	{
+		double cells_x = floor(((double)max_x - min_x) / m_cell_size) + 1.0;
+		double cells_y = floor(((double)max_y - min_y) / m_cell_size) + 1.0;
+		if (cells_x * cells_y <= cell_budget)
+		{
+			m_cells_x = (int)cells_x;
+			m_cells_y = (int)cells_y;
+			break;
+		}
+		m_cell_size *= 2.0f;
+	}
+
+	int cell_count = m_cells_x * m_cells_y;
+	m_cell_start.assign(cell_count + 1, 0);
+
+	for (int i = 0; i < entity_count; i++)
+	{
+		if (!entities[i].is_active()) continue;
+
+		glm::vec3 position = entities[i].get_position();
+		int cell = cell_y(position.y) * m_cells_x + cell_x(position.x);
+		m_entity_cell[i] = cell;
+		m_cell_start[cell + 1]++;
+	}
+
+	for (int c = 0; c < cell_count; c++) m_cell_start[c + 1] += m_cell_start[c];
+
+	m_entries.resize(m_cell_start[cell_count]);
+	m_fill.assign(m_cell_start.begin(), m_cell_start.end() - 1);
+	for (int i = 0; i < entity_count; i++)
+	{
+		if (m_entity_cell[i] < 0) continue;
+		m_entries[m_fill[m_entity_cell[i]]++] = i;
+	}
+}
+
+/*
+* Finds everything that may overlap a box
+*
+* @param position, centre of the box
+* @param width, width of the box
+* @param height, height of the box
+*
+* @return indices into the array given to build, in ascending order
+*/
+const std::vector<int>& SpatialGrid::query(glm::vec3 position, float width, float height)
+{
+	m_candidates.clear();
+	if (m_cells_x == 0 || m_cells_y == 0) return m_candidates;
+
+	float reach_x = (width / 2.0f) + m_max_half_width;
+	float reach_y = (height / 2.0f) + m_max_half_height;
+
+	int x_begin = cell_x(position.x - reach_x), x_end = cell_x(position.x + reach_x);
+	int y_begin = cell_y(position.y - reach_y), y_end = cell_y(position.y + reach_y);
+
+	for (int y = y_begin; y <= y_end; y++)
+	{
+		for (int x = x_begin; x <= x_end; x++)
+		{
+			int cell = y * m_cells_x + x;
+			m_candidates.insert(m_candidates.end(),
+				m_entries.begin() + m_cell_start[cell], m_entries.begin() + m_cell_start[cell + 1]);
+		}
+	}
+
+	// same order the old loop over the whole array used
+	std::sort(m_candidates.begin(), m_candidates.end());
+	return m_candidates;
+}
+
+/*
+* Lists every pair of entities in the same or neighbouring cells
+*
+* @param pairs, filled with (i, j), i < j, indices into the array given to build
+*/
+void SpatialGrid::find_pairs(std::vector<std::pair<int, int>>& pairs) const
+{
+	pairs.clear();
+
+	for (int y = 0; y < m_cells_y; y++)
+	{
+		for (int x = 0; x < m_cells_x; x++)
+		{
+			int cell = y * m_cells_x + x;
+			for (int a = m_cell_start[cell]; a < m_cell_start[cell + 1]; a++)
+			{
+				int first = m_entries[a];
+
+				// 3x3 block -- the i < j test keeps each pair once
+				for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, m_cells_y - 1); ny++)
+				{
+					for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, m_cells_x - 1); nx++)
+					{
+						int neighbour = ny * m_cells_x + nx;
+						for (int b = m_cell_start[neighbour]; b < m_cell_start[neighbour + 1]; b++)
+						{
+							if (m_entries[b] > first) pairs.push_back(std::make_pair(first, m_entries[b]));
+						}
+					}
+				}
+			}
+		}
+	}
+}
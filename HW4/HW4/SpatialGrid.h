@@ -0,0 +1,54 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include "glm/vec3.hpp"
+
+class Entity;
+
+/*
+* Uniform grid broadphase for ENTITY vs ENTITY collision
+* The caller rebuilds it with build() before each round of queries -- each
+* entity goes in the cell that holds its centre, and cells are at least as big as the largest entity, so
+* anything it can touch is in the surrounding 3x3 block of cells
+*/
+class SpatialGrid
+{
+private:
+	float m_tile_size;
+	float m_cell_size;
+
+	// grid covers the entities' bounds from the last build
+	float m_origin_x, m_origin_y;
+	int   m_cells_x, m_cells_y;
+
+	// largest half extent seen in the last build -- queries grow by this much
+	float m_max_half_width, m_max_half_height;
+
+	// cell c holds m_entries[m_cell_start[c] .. m_cell_start[c + 1]]
+	std::vector<int> m_cell_start;
+	std::vector<int> m_entries;
+	std::vector<int> m_entity_cell;
+
+	std::vector<int> m_candidates;
+	std::vector<int> m_fill; // build's next free entry per cell -- kept so a rebuild doesn't allocate
+
+	int cell_x(float x) const;
+	int cell_y(float y) const;
+
+public:
+	// cell size is a whole number of tiles
+	SpatialGrid(float tile_size);
+
+	void build(Entity* entities, int entity_count);
+
+	// indices into the array given to build, ascending, for everything that may overlap the box
+	const std::vector<int>& query(glm::vec3 position, float width, float height);
+
+	// every (i, j) with i < j that may overlap
+	void find_pairs(std::vector<std::pair<int, int>>& pairs) const;
+
+	// GETTERS
+	float const get_cell_size() const { return m_cell_size; }
+	int   const get_cells_x()   const { return m_cells_x; }
+	int   const get_cells_y()   const { return m_cells_y; }
+};
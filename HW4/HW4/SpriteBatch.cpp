@@ -0,0 +1,174 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include "glm/mat4x4.hpp"
+#include "SpriteBatch.h"
+#include "RenderState.h"
+
+// 16-bit indices reach 65536 corners, so bigger frames go out in chunks this size
+const int MAX_SPRITES_PER_FLUSH = 65536 / 4;
+
+const int FLOATS_PER_CORNER = 4;
+const int FLOATS_PER_SPRITE = 4 * FLOATS_PER_CORNER;
+
+/*
+* Makes the GL buffers -- call once the GL context exists
+* The index buffer never changes: two triangles per quad, same winding as Entity::render
+*/
+void SpriteBatch::initialise()
+{
+	std::vector<GLushort> indices(MAX_SPRITES_PER_FLUSH * 6);
+	for (int sprite = 0; sprite < MAX_SPRITES_PER_FLUSH; sprite++)
+	{
+		GLushort corner = (GLushort)(sprite * 4);
+		GLushort quad[] = { corner, (GLushort)(corner + 1), (GLushort)(corner + 2),
+			corner, (GLushort)(corner + 2), (GLushort)(corner + 3) };
+		std::copy(quad, quad + 6, indices.begin() + sprite * 6);
+	}
+
+	glGenBuffers(1, &m_vertex_buffer);
+	glGenBuffers(1, &m_index_buffer);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_index_buffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void SpriteBatch::shutdown()
+{
+	glDeleteBuffers(1, &m_vertex_buffer);
+	glDeleteBuffers(1, &m_index_buffer);
+	m_vertex_buffer = 0;
+	m_index_buffer = 0;
+}
+
+// starts a new frame's batch
+void SpriteBatch::begin()
+{
+	m_sprites.clear();
+}
+
+/*
+* Queues one sprite -- nothing reaches GL until end()
+*
+* @param texture_id, the sprite's texture
+* @param position, centre of the sprite in world space
+* @param width, height, size in world units -- entities are 1x1
+* @param layer, lower layers are drawn first, whatever their texture -- -32768 to 32767
+*/
+void SpriteBatch::draw(GLuint texture_id, glm::vec3 position, float width, float height, glm::vec4 atlas, int layer)
+{
+	Sprite sprite;
+	// biased so negative layers sort below positive ones
+	sprite.key = ((uint64_t)(uint16_t)(layer + 0x8000) << 48) | ((uint64_t)(texture_id & 0xffff) << 32) | (uint32_t)m_sprites.size();
+	sprite.texture_id = texture_id;
+	sprite.position = position;
+	sprite.width = width;
+	sprite.height = height;
+	sprite.atlas = atlas;
+	m_sprites.push_back(sprite);
+}
+
+/*
+* Sorts the frame's sprites, streams them into the vertex buffer and draws them
+*
+* @param program, the textured SHADERPROGRAM -- the model matrix is left at identity
+*/
+void SpriteBatch::end(ShaderProgram* program)
+{
+	m_draw_calls = 0;
+	m_sprite_count = (int)m_sprites.size();
+	if (m_sprites.empty()) return;
+
+	std::sort(m_sprites.begin(), m_sprites.end(),
+		[](const Sprite& a, const Sprite& b) { return a.key < b.key; });
+
+	// corners are built on the CPU in world space -- same quad and UVs as Entity::render
+	m_vertices.resize(m_sprites.size() * FLOATS_PER_SPRITE);
+	float* vertex = m_vertices.data();
+	for (const Sprite& sprite : m_sprites)
+	{
+		float left = sprite.position.x - sprite.width / 2;
+		float right = sprite.position.x + sprite.width / 2;
+		float bottom = sprite.position.y - sprite.height / 2;
+		float top = sprite.position.y + sprite.height / 2;
+
+		float u_left = sprite.atlas.x;
+		float u_right = sprite.atlas.x + sprite.atlas.z;
+		float v_top = sprite.atlas.y;
+		float v_bottom = sprite.atlas.y + sprite.atlas.w;
+
+		float corners[] = {
+			left,  bottom, u_left,  v_bottom,
+			right, bottom, u_right, v_bottom,
+			right, top,    u_right, v_top,
+			left,  top,    u_left,  v_top
+		};
+		std::copy(corners, corners + FLOATS_PER_SPRITE, vertex);
+		vertex += FLOATS_PER_SPRITE;
+	}
+
+	g_render_state.use_program(program->get_program_id());
+	program->set_model_matrix(glm::mat4(1.0f));
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertex_buffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_index_buffer);
+
+	// orphan last frame's storage so the driver never waits on the GPU
+	glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(float), nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, m_vertices.size() * sizeof(float), m_vertices.data());
+
+	g_render_state.enable_attribute(program->get_position_attribute());
+	g_render_state.enable_attribute(program->get_tex_coordinate_attribute());
+
+	for (int first = 0; first < m_sprite_count; first += MAX_SPRITES_PER_FLUSH)
+	{
+		flush(program, first, std::min(MAX_SPRITES_PER_FLUSH, m_sprite_count - first));
+	}
+
+	// Entity::render and TilemapRenderer::render still pass client-side arrays
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+/*
+* Draws one chunk of sorted sprites, one call per run of the same texture
+*
+* @param program, the textured SHADERPROGRAM
+* @param first, index of the chunk's first sprite
+* @param count, sprites in the chunk -- at most MAX_SPRITES_PER_FLUSH
+*/
+void SpriteBatch::flush(ShaderProgram* program, int first, int count)
+{
+	GLsizei stride = FLOATS_PER_CORNER * sizeof(float);
+	size_t offset = (size_t)first * FLOATS_PER_SPRITE * sizeof(float);
+
+	glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, stride, (const void*)offset);
+	glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, stride,
+		(const void*)(offset + 2 * sizeof(float)));
+
+	int run_start = 0;
+	while (run_start < count)
+	{
+		GLuint texture_id = m_sprites[first + run_start].texture_id;
+		int run_end = run_start + 1;
+		while (run_end < count && m_sprites[first + run_end].texture_id == texture_id) run_end++;
+
+		g_render_state.bind_texture(texture_id);
+		glDrawElements(GL_TRIANGLES, (run_end - run_start) * 6, GL_UNSIGNED_SHORT,
+			(const void*)(run_start * 6 * sizeof(GLushort)));
+		m_draw_calls++;
+
+		run_start = run_end;
+	}
+}
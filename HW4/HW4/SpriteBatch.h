@@ -0,0 +1,58 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include <stdint.h>
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "ShaderProgram.h"
+
+/*
+* Collects every sprite drawn in a frame and sends them to the GPU together
+* Sprites are sorted by layer then texture, written into one streamed vertex
+* buffer, and drawn with one call per run of the same texture
+*
+* usage: begin() -> draw() for each sprite -> end(program)
+*/
+class SpriteBatch
+{
+private:
+	struct Sprite
+	{
+		uint64_t  key; // layer, texture, then draw order -- sorting by it keeps the batch stable
+		GLuint    texture_id;
+		glm::vec3 position;
+		float     width;
+		float     height;
+		glm::vec4 atlas; // u, v, width, height in the texture
+	};
+
+	std::vector<Sprite> m_sprites;
+	std::vector<float>  m_vertices; // x, y, u, v per corner, four corners per sprite
+
+	GLuint m_vertex_buffer = 0;
+	GLuint m_index_buffer = 0;
+
+	// last frame's numbers
+	int m_draw_calls = 0;
+	int m_sprite_count = 0;
+
+	void flush(ShaderProgram* program, int first, int count);
+
+public:
+	void initialise();
+	void shutdown();
+
+	void begin();
+	void draw(GLuint texture_id, glm::vec3 position, float width = 1.0f, float height = 1.0f,
+		glm::vec4 atlas = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), int layer = 0);
+	void end(ShaderProgram* program);
+
+	// GETTERS
+	int const get_draw_calls()   const { return m_draw_calls; };
+	int const get_sprite_count() const { return m_sprite_count; };
+};
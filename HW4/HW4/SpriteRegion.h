@@ -0,0 +1,13 @@
+#pragma once
+#include "glm/vec4.hpp"
+
+/*
+* Where a sprite sits -- the texture (an atlas page, usually) and the part of it
+* to draw as u, v, width, height. Plain data, so the simulation side can carry it
+* without knowing about GL
+*/
+struct SpriteRegion
+{
+	unsigned int texture_id = 0; // GL name, only used by the renderer
+	glm::vec4    rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+};
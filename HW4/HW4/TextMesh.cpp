@@ -0,0 +1,126 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "TextMesh.h"
+#include "RenderState.h"
+
+const int FLOATS_PER_CHARACTER = 6 * 4; // two triangles of x, y, u, v
+
+/*
+* Works out where each character sits on the font sheet
+*
+* @param fontbank_size, glyphs along each side of the sheet
+*/
+void GlyphTable::build(int fontbank_size)
+{
+	glyph_size = 1.0f / fontbank_size;
+	for (int character = 0; character < 256; character++)
+	{
+		uvs[character][0] = (float)(character % fontbank_size) / fontbank_size;
+		uvs[character][1] = (float)(character / fontbank_size) / fontbank_size;
+	}
+}
+
+/*
+* Lays the text out into the buffer -- does nothing if it's the same as last time
+*
+* @param glyphs, the font sheet's GLYPHTABLE
+* @param text, the line to show
+* @param screen_size, height and width of each character
+* @param spacing, extra gap between characters, negative to squeeze them together
+*/
+void TextMesh::set_text(const GlyphTable& glyphs, const std::string& text, float screen_size, float spacing)
+{
+	if (m_layout_count > 0 && text == m_text && screen_size == m_screen_size && spacing == m_spacing) return;
+
+	m_text = text;
+	m_screen_size = screen_size;
+	m_spacing = spacing;
+	m_layout_count++;
+
+	float half = 0.5f * screen_size;
+	float size = glyphs.glyph_size;
+
+	m_vertices.resize(text.size() * FLOATS_PER_CHARACTER);
+	float* vertex = m_vertices.data();
+	for (size_t i = 0; i < text.size(); i++)
+	{
+		const float* uv = glyphs.uvs[(unsigned char)text[i]];
+		float offset = (screen_size + spacing) * i;
+
+		// same corners and order draw_text used
+		float corners[FLOATS_PER_CHARACTER] = {
+			offset - half,  half, uv[0],        uv[1],
+			offset - half, -half, uv[0],        uv[1] + size,
+			offset + half,  half, uv[0] + size, uv[1],
+			offset + half, -half, uv[0] + size, uv[1] + size,
+			offset + half,  half, uv[0] + size, uv[1],
+			offset - half, -half, uv[0],        uv[1] + size
+		};
+		std::copy(corners, corners + FLOATS_PER_CHARACTER, vertex);
+		vertex += FLOATS_PER_CHARACTER;
+	}
+
+	if (m_vertex_buffer == 0) glGenBuffers(1, &m_vertex_buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertex_buffer);
+
+	// grow only -- a shorter string reuses the storage
+	if ((int)text.size() > m_capacity)
+	{
+		m_capacity = (int)text.size();
+		glBufferData(GL_ARRAY_BUFFER, (size_t)m_capacity * FLOATS_PER_CHARACTER * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+	}
+	if (!m_vertices.empty()) glBufferSubData(GL_ARRAY_BUFFER, 0, m_vertices.size() * sizeof(float), m_vertices.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/*
+* Draws the text as it was last laid out
+*
+* @param program, the textured SHADERPROGRAM
+* @param font_texture_id, the font sheet the GLYPHTABLE describes
+* @param position, where the first character's centre goes
+*/
+void TextMesh::render(ShaderProgram* program, GLuint font_texture_id, glm::vec3 position)
+{
+	if (m_text.empty()) return;
+
+	glm::mat4 model_matrix = glm::translate(glm::mat4(1.0f), position);
+	g_render_state.use_program(program->get_program_id());
+	program->set_model_matrix(model_matrix);
+
+	GLsizei stride = 4 * sizeof(float);
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertex_buffer);
+	glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, stride, (const void*)0);
+	g_render_state.enable_attribute(program->get_position_attribute());
+	glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, stride, (const void*)(2 * sizeof(float)));
+	g_render_state.enable_attribute(program->get_tex_coordinate_attribute());
+
+	g_render_state.bind_texture(font_texture_id);
+	glDrawArrays(GL_TRIANGLES, 0, (int)m_text.size() * 6);
+
+	// the per-entity path still passes client-side arrays
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// frees the buffer -- needs the GL context, so call it before the window goes away
+void TextMesh::release()
+{
+	if (m_vertex_buffer != 0) glDeleteBuffers(1, &m_vertex_buffer);
+	m_vertex_buffer = 0;
+	m_capacity = 0;
+	m_layout_count = 0;
+	m_text.clear();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <string>
+#include <vector>
+#include "glm/vec3.hpp"
+#include "ShaderProgram.h"
+
+/*
+* UV corner of every character on a square font sheet of fontbank_size x fontbank_size
+* glyphs, laid out in ASCII order -- worked out once instead of per character drawn
+*/
+struct GlyphTable
+{
+	float uvs[256][2];
+	float glyph_size = 0.0f; // width and height of one glyph in UV units
+
+	void build(int fontbank_size);
+};
+
+/*
+* A line of text whose quads live in a GPU buffer -- laid out by set_text() only
+* when the string or its spacing changes, so drawing it every frame costs a
+* bind and one draw call
+*
+* usage: set_text(glyphs, text, ...) whenever -> render(program, font, position) each frame
+*/
+class TextMesh
+{
+private:
+	std::string m_text;
+	float m_screen_size = 0.0f;
+	float m_spacing = 0.0f;
+
+	GLuint m_vertex_buffer = 0;
+	int    m_capacity = 0; // characters the buffer has room for
+	int    m_layout_count = 0;
+
+	std::vector<float> m_vertices; // x, y, u, v per corner -- scratch for the layout
+
+public:
+	void set_text(const GlyphTable& glyphs, const std::string& text, float screen_size, float spacing);
+	void render(ShaderProgram* program, GLuint font_texture_id, glm::vec3 position);
+	void release();
+
+	// GETTERS
+	const std::string& get_text() const { return m_text; };
+	int const get_layout_count() const { return m_layout_count; };
+};
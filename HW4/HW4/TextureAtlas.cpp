@@ -0,0 +1,243 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+#define LOG(argument) std::cout << argument << '\n'
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <assert.h>
+#include "stb_image.h" // STB_IMAGE_IMPLEMENTATION is in main.cpp
+#include "TextureAtlas.h"
+#include "RenderState.h"
+
+const int BYTES_PER_PIXEL = 4; // everything is packed as RGBA
+const int PADDING = 1;         // texels of copied edge around each image
+
+/*
+* Queues an image for the atlas -- adding the same file twice is harmless
+*
+* @param filepath, the image to pack
+*/
+void TextureAtlas::add(const char* filepath)
+{
+	if (m_images_by_path.count(filepath) > 0) return;
+
+	m_images_by_path[filepath] = (int)m_images.size();
+	Image image;
+	image.filepath = filepath;
+	m_images.push_back(image);
+}
+
+/*
+* Starts decoding every added image on the pool, so it overlaps window and GL
+* start-up. Nothing may be added after this until build() has run
+*
+* @param pool, the THREADPOOL to decode on -- it must be finished before build()
+*/
+void TextureAtlas::decode_async(ThreadPool& pool)
+{
+	for (Image& image : m_images)
+	{
+		if (image.decoded) continue;
+
+		// each job only touches its own image, so no locking is needed
+		Image* target = &image;
+		pool.submit([this, target]() { decode(*target); });
+	}
+}
+
+/*
+* Reads one image -- straight from the archive when it has the file
+*
+* @param image, the image to fill in
+*/
+void TextureAtlas::decode(Image& image)
+{
+	const ArchiveEntry* entry = m_archive ? m_archive->find(image.filepath.c_str()) : nullptr;
+	if (entry != nullptr && entry->type == ARCHIVE_TEXTURE_RGBA)
+	{
+		image.pixels = m_archive->get_data(entry);
+		image.width = (int)entry->width;
+		image.height = (int)entry->height;
+		image.from_archive = true;
+	}
+	else
+	{
+		int number_of_components;
+		image.pixels = stbi_load(image.filepath.c_str(), &image.width, &image.height, &number_of_components, STBI_rgb_alpha);
+	}
+	image.decoded = true;
+}
+
+/*
+* Packs the images into pages and uploads them -- must run on the GL thread
+* Anything decode_async() didn't get to is decoded here
+*
+* @param page_size, the widest and tallest a page may be -- an image bigger than
+* that gets a page of its own
+*/
+void TextureAtlas::build(int page_size)
+{
+	for (Image& image : m_images)
+	{
+		if (!image.decoded) decode(image);
+
+		// Throw error if no image found at filepath
+		if (image.pixels == NULL)
+		{
+			LOG(" Unable to load image. Make sure the path is correct.");
+			assert(false);
+		}
+	}
+
+	GLint max_size = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+	page_size = std::min(page_size, (int)max_size);
+
+	// tallest first keeps the shelves full
+	std::vector<int> order;
+	for (int i = 0; i < (int)m_images.size(); i++) if (m_images[i].pixels != NULL) order.push_back(i);
+	std::sort(order.begin(), order.end(), [this](int a, int b) {
+		return m_images[a].height != m_images[b].height ? m_images[a].height > m_images[b].height
+			: m_images[a].width > m_images[b].width;
+	});
+
+	// place every image -- x, y of its padded corner and the page it's on
+	struct Placement { int page, x, y; };
+	std::vector<Placement> placements(m_images.size());
+	std::vector<int> page_widths, page_heights;
+
+	int shelf_x = 0, shelf_y = 0, shelf_height = 0;
+	bool page_full = false;
+	for (int i : order)
+	{
+		int width = m_images[i].width + PADDING * 2;
+		int height = m_images[i].height + PADDING * 2;
+
+		// too big for any page -- it goes on one of its own, so no other page grows past page_size
+		bool oversized = width > page_size || height > page_size;
+
+		if (page_widths.empty() || page_full || oversized || shelf_x + width > page_size)
+		{
+			// next shelf -- or the next page when this one is full
+			shelf_y += shelf_height;
+			shelf_x = 0;
+			shelf_height = 0;
+			if (page_widths.empty() || page_full || oversized || shelf_y + height > page_size)
+			{
+				page_widths.push_back(0);
+				page_heights.push_back(0);
+				shelf_y = 0;
+				page_full = false;
+			}
+		}
+		page_full = oversized;
+
+		int page = (int)page_widths.size() - 1;
+		placements[i] = { page, shelf_x, shelf_y };
+		shelf_x += width;
+		shelf_height = std::max(shelf_height, height);
+
+		// pages are trimmed to what they hold
+		page_widths[page] = std::max(page_widths[page], shelf_x);
+		page_heights[page] = std::max(page_heights[page], shelf_y + height);
+	}
+
+	size_t first_page = m_pages.size();
+	for (int page = 0; page < (int)page_widths.size(); page++)
+	{
+		int page_width = page_widths[page];
+		int page_height = page_heights[page];
+		std::vector<unsigned char> texels((size_t)page_width * page_height * BYTES_PER_PIXEL, 0);
+
+		for (int i : order)
+		{
+			if (placements[i].page != page) continue;
+			const Image& image = m_images[i];
+
+			// each padded row repeats the image's edge texels, and the padding rows repeat its edge rows
+			for (int row = -PADDING; row < image.height + PADDING; row++)
+			{
+				int source_row = std::min(std::max(row, 0), image.height - 1);
+				const unsigned char* source = image.pixels + (size_t)source_row * image.width * BYTES_PER_PIXEL;
+				unsigned char* target = texels.data()
+					+ ((size_t)(placements[i].y + PADDING + row) * page_width + placements[i].x) * BYTES_PER_PIXEL;
+
+				for (int pad = 0; pad < PADDING; pad++)
+				{
+					memcpy(target + pad * BYTES_PER_PIXEL, source, BYTES_PER_PIXEL);
+					memcpy(target + (PADDING + image.width + pad) * BYTES_PER_PIXEL,
+						source + (image.width - 1) * BYTES_PER_PIXEL, BYTES_PER_PIXEL);
+				}
+				memcpy(target + PADDING * BYTES_PER_PIXEL, source, (size_t)image.width * BYTES_PER_PIXEL);
+			}
+		}
+
+		GLuint texture_id;
+		glGenTextures(1, &texture_id);
+		g_render_state.bind_texture(texture_id);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, page_width, page_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+
+		// NEAREST better for pixel art
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		m_pages.push_back(texture_id);
+		m_page_bytes += texels.size();
+	}
+
+	for (int i : order)
+	{
+		Image& image = m_images[i];
+		float page_width = (float)page_widths[placements[i].page];
+		float page_height = (float)page_heights[placements[i].page];
+
+		image.region.texture_id = m_pages[first_page + placements[i].page];
+		image.region.rect = glm::vec4((placements[i].x + PADDING) / page_width, (placements[i].y + PADDING) / page_height,
+			image.width / page_width, image.height / page_height);
+	}
+
+	// the pages have their own copy now
+	for (Image& image : m_images)
+	{
+		if (image.pixels != NULL && !image.from_archive) stbi_image_free((void*)image.pixels);
+		image.pixels = nullptr;
+	}
+}
+
+// frees every page -- regions handed out before now point at nothing
+void TextureAtlas::unload()
+{
+	for (GLuint page : m_pages) g_render_state.forget_texture(page);
+	if (!m_pages.empty()) glDeleteTextures((GLsizei)m_pages.size(), m_pages.data());
+
+	m_pages.clear();
+	m_images.clear();
+	m_images_by_path.clear();
+	m_page_bytes = 0;
+}
+
+/*
+* Where a packed image ended up
+*
+* @param filepath, the file given to add()
+*
+* @return its page and rectangle, or an empty region if it was never added or built
+*/
+SpriteRegion TextureAtlas::find(const char* filepath) const
+{
+	auto found = m_images_by_path.find(filepath);
+	return found != m_images_by_path.end() ? m_images[found->second].region : SpriteRegion();
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "SpriteRegion.h"
+#include "ThreadPool.h"
+#include "AssetArchive.h"
+
+/*
+* Packs sprite images into as few textures (pages) as will hold them, so sprites
+* from different files can share one bind and one draw call
+* Images are placed on shelves, tallest first, with a one texel border copied
+* from their edges so nothing bleeds in from a neighbour
+*
+* usage: add() each file -> decode_async(pool) (optional, before GL exists)
+* -> build() on the GL thread once the pool is done -> find() each file's SPRITEREGION
+*/
+class TextureAtlas
+{
+private:
+	struct Image
+	{
+		std::string filepath;
+		const unsigned char* pixels = nullptr;
+		int  width = 0;
+		int  height = 0;
+		bool decoded = false;      // pixels is NULL after this if the file couldn't be read
+		bool from_archive = false; // points into the archive -- not freed after packing
+		SpriteRegion region;
+	};
+
+	std::vector<Image> m_images;
+	std::unordered_map<std::string, int> m_images_by_path;
+	std::vector<GLuint> m_pages;
+	size_t m_page_bytes = 0;
+
+	const AssetArchive* m_archive = nullptr;
+
+	void decode(Image& image);
+
+public:
+	void add(const char* filepath);
+	void decode_async(ThreadPool& pool);
+	void build(int page_size = 1024);
+	void unload();
+
+	SpriteRegion find(const char* filepath) const;
+
+	// the archive must stay open until build() has run
+	void set_archive(const AssetArchive* archive) { m_archive = archive; };
+
+	// GETTERS
+	int    const get_page_count()  const { return (int)m_pages.size(); };
+	size_t const get_page_bytes()  const { return m_page_bytes; };
+	int    const get_image_count() const { return (int)m_images.size(); };
+};
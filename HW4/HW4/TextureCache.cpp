@@ -0,0 +1,288 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+#define LOG(argument) std::cout << argument << '\n'
+
+#include <iostream>
+#include <assert.h>
+#include "stb_image.h" // STB_IMAGE_IMPLEMENTATION is in main.cpp
+#include "TextureCache.h"
+#include "RenderState.h"
+
+// texture constants
+const int NUMBER_OF_TEXTURES = 1;
+const GLint LEVEL_OF_DETAIL = 0;
+const GLint TEXTURE_BORDER = 0;
+const int BYTES_PER_PIXEL = 4; // everything is uploaded as RGBA
+
+/*
+* Hands out a texture, loading it the first time its file is asked for
+* 
+* @param filepath, an array of chars that represents the text name
+  of the filepath of the texture for the sprite
+*
+* @return a handle holding one reference -- give it back with release()
+*/
+TextureHandle TextureCache::acquire(const char* filepath)
+{
+	auto cached = m_slots_by_path.find(filepath);
+	if (cached != m_slots_by_path.end())
+	{
+		Texture& texture = m_textures[cached->second];
+		texture.ref_count++;
+		return TextureHandle{ cached->second, texture.generation };
+	}
+
+	// already decoded in the archive -- upload straight from the mapping
+	const ArchiveEntry* entry = m_archive ? m_archive->find(filepath) : nullptr;
+	if (entry != nullptr && entry->type == ARCHIVE_TEXTURE_RGBA)
+	{
+		int slot = take_slot(filepath);
+		upload(slot, m_archive->get_data(entry), entry->width, entry->height);
+		return TextureHandle{ slot, m_textures[slot].generation };
+	}
+
+	// Load image file from filepath
+	int width, height, number_of_components;
+	unsigned char* image = stbi_load(filepath, &width, &height, &number_of_components, STBI_rgb_alpha);
+
+	// Throw error if no image found at filepath
+	if (image == NULL)
+	{
+		LOG(" Unable to load image. Make sure the path is correct.");
+		assert(false);
+		return TextureHandle();
+	}
+
+	int slot = take_slot(filepath);
+	upload(slot, image, width, height);
+	stbi_image_free(image);
+
+	return TextureHandle{ slot, m_textures[slot].generation };
+}
+
+/*
+* Same as acquire, but the file is decoded on a worker thread
+* The handle's texture reads as 0 until finish_loading() has run
+*
+* @param filepath, the image to load
+* @param pool, the THREADPOOL to decode on
+*
+* @return a handle holding one reference -- give it back with release()
+*/
+TextureHandle TextureCache::acquire_async(const char* filepath, ThreadPool& pool)
+{
+	auto cached = m_slots_by_path.find(filepath);
+	if (cached != m_slots_by_path.end())
+	{
+		Texture& texture = m_textures[cached->second];
+		texture.ref_count++;
+		return TextureHandle{ cached->second, texture.generation };
+	}
+
+	int slot = take_slot(filepath);
+	m_textures[slot].pending = true;
+	m_pending_count++;
+
+	// nothing to decode -- queue the archive's texels for finish_loading
+	const ArchiveEntry* entry = m_archive ? m_archive->find(filepath) : nullptr;
+	if (entry != nullptr && entry->type == ARCHIVE_TEXTURE_RGBA)
+	{
+		DecodedImage decoded = { slot, m_archive->get_data(entry), (int)entry->width, (int)entry->height, true };
+		std::lock_guard<std::mutex> lock(m_decoded_mutex);
+		m_decoded.push_back(decoded);
+		return TextureHandle{ slot, m_textures[slot].generation };
+	}
+
+	std::string path = filepath;
+	pool.submit([this, slot, path]()
+	{
+		DecodedImage decoded;
+		int number_of_components;
+		decoded.slot = slot;
+		decoded.from_archive = false;
+		decoded.pixels = stbi_load(path.c_str(), &decoded.width, &decoded.height, &number_of_components, STBI_rgb_alpha);
+
+		std::lock_guard<std::mutex> lock(m_decoded_mutex);
+		m_decoded.push_back(decoded);
+		m_decoded_ready.notify_one();
+	});
+
+	return TextureHandle{ slot, m_textures[slot].generation };
+}
+
+/*
+* Uploads every image acquire_async() queued, in the order the decodes finish
+* Must run on the thread that owns the GL context -- blocks until all are in
+*/
+void TextureCache::finish_loading()
+{
+	std::vector<DecodedImage> ready;
+	while (m_pending_count > 0)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_decoded_mutex);
+			m_decoded_ready.wait(lock, [this]() { return !m_decoded.empty(); });
+			ready.swap(m_decoded);
+		}
+
+		for (const DecodedImage& decoded : ready)
+		{
+			m_textures[decoded.slot].pending = false;
+			m_pending_count--;
+
+			// Throw error if no image found at filepath
+			if (decoded.pixels == NULL)
+			{
+				LOG(" Unable to load image. Make sure the path is correct.");
+				assert(false);
+				continue;
+			}
+
+			upload(decoded.slot, decoded.pixels, decoded.width, decoded.height);
+			if (!decoded.from_archive) stbi_image_free((void*)decoded.pixels);
+		}
+		ready.clear();
+	}
+}
+
+/*
+* Gives back one reference -- the handle is emptied so it can't be released twice
+*
+* @param handle, a handle from acquire()
+*/
+void TextureCache::release(TextureHandle& handle)
+{
+	if (find(handle) != nullptr) m_textures[handle.slot].ref_count--;
+	handle = TextureHandle();
+}
+
+// frees every texture nobody holds a reference to
+void TextureCache::unload_unused()
+{
+	for (int slot = 0; slot < (int)m_textures.size(); slot++)
+	{
+		const Texture& texture = m_textures[slot];
+		if (!texture.filepath.empty() && !texture.pending && texture.ref_count <= 0) unload(slot);
+	}
+}
+
+// frees everything but unfinished decodes -- any handles still out go stale
+void TextureCache::unload_all()
+{
+	for (int slot = 0; slot < (int)m_textures.size(); slot++)
+	{
+		const Texture& texture = m_textures[slot];
+		if (!texture.filepath.empty() && !texture.pending) unload(slot);
+	}
+}
+
+/*
+* The GL name to bind for a handle
+*
+* @param handle, a handle from acquire()
+*
+* @return 0 for an empty or stale handle, or one still decoding
+*/
+GLuint TextureCache::get_texture_id(TextureHandle handle) const
+{
+	const Texture* texture = find(handle);
+	return texture ? texture->texture_id : 0;
+}
+
+const TextureCache::Texture* TextureCache::find(TextureHandle handle) const
+{
+	if (handle.slot < 0 || handle.slot >= (int)m_textures.size()) return nullptr;
+
+	const Texture& texture = m_textures[handle.slot];
+	if (texture.filepath.empty() || texture.generation != handle.generation) return nullptr;
+	return &texture;
+}
+
+/*
+* Claims a slot for a new file -- reuses one left by an unloaded texture if there is one
+*
+* @param filepath, the file the slot will hold
+*/
+int TextureCache::take_slot(const char* filepath)
+{
+	int slot;
+	if (!m_free_slots.empty())
+	{
+		slot = m_free_slots.back();
+		m_free_slots.pop_back();
+	}
+	else
+	{
+		slot = (int)m_textures.size();
+		m_textures.push_back(Texture());
+	}
+
+	Texture& texture = m_textures[slot];
+	texture.filepath = filepath;
+	texture.ref_count = 1;
+	texture.generation++;
+	m_slots_by_path[texture.filepath] = slot;
+
+	return slot;
+}
+
+/*
+* Makes the GL texture for a decoded image -- the caller still owns the pixels
+*
+* @param slot, the slot from take_slot
+* @param image, RGBA pixels from stbi_load or the archive
+* @param width, height, the image's size in pixels
+*/
+void TextureCache::upload(int slot, const unsigned char* image, int width, int height)
+{
+	// Generate and bind texture ID to image
+	GLuint textureID;
+	glGenTextures(NUMBER_OF_TEXTURES, &textureID);
+	g_render_state.bind_texture(textureID);
+	glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_RGBA, width, height, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, image);
+
+	// Setting up texture filter parameters
+	// NEAREST better for pixel art
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	Texture& texture = m_textures[slot];
+	texture.texture_id = textureID;
+	texture.width = width;
+	texture.height = height;
+
+	m_live_count++;
+	m_live_bytes += (size_t)width * height * BYTES_PER_PIXEL;
+	m_load_count++;
+}
+
+void TextureCache::unload(int slot)
+{
+	Texture& texture = m_textures[slot];
+
+	// a file that failed to decode never got a GL texture
+	if (texture.texture_id != 0)
+	{
+		glDeleteTextures(NUMBER_OF_TEXTURES, &texture.texture_id);
+		g_render_state.forget_texture(texture.texture_id);
+		m_live_count--;
+		m_live_bytes -= (size_t)texture.width * texture.height * BYTES_PER_PIXEL;
+	}
+
+	m_slots_by_path.erase(texture.filepath);
+	texture.filepath.clear();
+	texture.texture_id = 0;
+	texture.ref_count = 0;
+	m_free_slots.push_back(slot);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <stdint.h>
+#include "ThreadPool.h"
+#include "AssetArchive.h"
+
+/*
+* Refers to one texture in a TEXTURECACHE
+* Copying it doesn't add a reference -- only acquire() does
+*/
+struct TextureHandle
+{
+	int      slot = -1;
+	uint32_t generation = 0; // stale handles to a reused slot are caught by this
+};
+
+/*
+* Every texture the game has loaded, keyed by file path
+* Each file is decoded and uploaded once, however many times it's acquired.
+* Releasing the last reference keeps the texture cached until unload_unused()
+*
+* acquire_async() decodes on a THREADPOOL instead; finish_loading() then does
+* the GL uploads on the GL thread, each one as soon as its decode is done
+*
+* With an ASSETARCHIVE set, files it holds skip decoding altogether -- their
+* texels go from the mapped archive straight to GL
+*/
+class TextureCache
+{
+private:
+	struct Texture
+	{
+		std::string filepath;
+		GLuint   texture_id = 0;
+		int      width = 0;
+		int      height = 0;
+		int      ref_count = 0;
+		uint32_t generation = 0;
+		bool     pending = false; // still decoding -- no GL texture yet
+	};
+
+	// a decode handed back from a worker thread
+	struct DecodedImage
+	{
+		int slot;
+		const unsigned char* pixels; // NULL if the file couldn't be read
+		int width;
+		int height;
+		bool from_archive; // points into the archive -- not freed after upload
+	};
+
+	std::vector<Texture> m_textures;
+	std::vector<int>     m_free_slots;
+	std::unordered_map<std::string, int> m_slots_by_path;
+
+	int    m_live_count = 0;
+	size_t m_live_bytes = 0;
+	int    m_load_count = 0; // files decoded since startup
+
+	// filled by the workers, emptied by finish_loading
+	std::mutex m_decoded_mutex;
+	std::condition_variable m_decoded_ready;
+	std::vector<DecodedImage> m_decoded;
+	int m_pending_count = 0;
+
+	const AssetArchive* m_archive = nullptr;
+
+	const Texture* find(TextureHandle handle) const;
+	int  take_slot(const char* filepath);
+	void upload(int slot, const unsigned char* image, int width, int height);
+	void unload(int slot);
+
+public:
+	TextureHandle acquire(const char* filepath);
+	TextureHandle acquire_async(const char* filepath, ThreadPool& pool);
+	void finish_loading();
+	void release(TextureHandle& handle);
+
+	void unload_unused();
+	void unload_all();
+
+	GLuint get_texture_id(TextureHandle handle) const;
+
+	// the archive must stay open while the cache is loading from it
+	void set_archive(const AssetArchive* archive) { m_archive = archive; };
+
+	// GETTERS
+	int    const get_live_count() const { return m_live_count; };
+	size_t const get_live_bytes() const { return m_live_bytes; };
+	int    const get_load_count() const { return m_load_count; };
+	int    const get_pending_count() const { return m_pending_count; };
+};
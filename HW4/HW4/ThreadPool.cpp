@@ -0,0 +1,147 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include "ThreadPool.h"
+#include "Profiler.h"
+
+// which worker the current thread is, -1 for threads outside the pool
+static thread_local int t_worker = -1;
+static thread_local ThreadPool* t_pool = nullptr;
+
+/*
+* ThreadPool Constructor
+*
+* @param thread_count, number of workers -- 0 uses every core
+*/
+ThreadPool::ThreadPool(int thread_count)
+	: m_queued(0), m_pending(0), m_next_queue(0)
+{
+	if (thread_count <= 0) thread_count = (int)std::thread::hardware_concurrency();
+	if (thread_count <= 0) thread_count = 1;
+
+	for (int i = 0; i < thread_count; i++) m_queues.push_back(new WorkerQueue());
+	for (int i = 0; i < thread_count; i++) m_threads.push_back(std::thread(&ThreadPool::worker_loop, this, i));
+}
+
+/*
+* Finishes whatever is still queued, then joins every worker
+*/
+ThreadPool::~ThreadPool()
+{
+	wait();
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+		m_stopping = true;
+	}
+	m_work_available.notify_all();
+
+	for (std::thread& thread : m_threads) thread.join();
+	for (WorkerQueue* queue : m_queues) delete queue;
+}
+
+/*
+* Queues a job
+* From a worker it goes on that worker's queue, otherwise queues take turns
+*
+* @param job, the work to run on some worker
+*/
+void ThreadPool::submit(std::function<void()> job)
+{
+	int queue = (t_pool == this) ? t_worker : (m_next_queue++ % (int)m_queues.size());
+
+	m_pending++;
+	{
+		std::lock_guard<std::mutex> lock(m_queues[queue]->mutex);
+		m_queues[queue]->jobs.push_back(std::move(job));
+	}
+	m_queued++;
+
+	// taking the lock keeps a worker from missing the wake up between its check and its wait
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+	}
+	m_work_available.notify_one();
+}
+
+/*
+* Blocks until every submitted job, including jobs they submit, has finished
+*/
+void ThreadPool::wait()
+{
+	std::unique_lock<std::mutex> lock(m_sleep_mutex);
+	m_all_done.wait(lock, [this] { return m_pending == 0; });
+}
+
+/*
+* Own queue first, newest job -- then the oldest job from everyone else
+*
+* @param worker, index of the calling worker
+* @param job, set to the job that was taken
+*
+* @return false when every queue was empty
+*/
+bool ThreadPool::pop_job(int worker, std::function<void()>& job)
+{
+	{
+		WorkerQueue* own = m_queues[worker];
+		std::lock_guard<std::mutex> lock(own->mutex);
+		if (!own->jobs.empty())
+		{
+			job = std::move(own->jobs.back());
+			own->jobs.pop_back();
+			m_queued--;
+			return true;
+		}
+	}
+
+	int queue_count = (int)m_queues.size();
+	for (int offset = 1; offset < queue_count; offset++)
+	{
+		WorkerQueue* victim = m_queues[(worker + offset) % queue_count];
+		std::lock_guard<std::mutex> lock(victim->mutex);
+		if (!victim->jobs.empty())
+		{
+			job = std::move(victim->jobs.front());
+			victim->jobs.pop_front();
+			m_queued--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ThreadPool::worker_loop(int worker)
+{
+	t_worker = worker;
+	t_pool = this;
+	profile_name_thread("worker");
+
+	std::function<void()> job;
+	for (;;)
+	{
+		if (pop_job(worker, job))
+		{
+			job();
+			job = nullptr;
+
+			if (--m_pending == 0)
+			{
+				std::lock_guard<std::mutex> lock(m_sleep_mutex);
+				m_all_done.notify_all();
+			}
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_sleep_mutex);
+		m_work_available.wait(lock, [this] { return m_stopping || m_queued > 0; });
+		if (m_stopping && m_queued == 0) return;
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+* Fixed set of worker threads with one job queue each
+* Workers run their own queue newest-first and, when it runs dry, steal the
+* oldest job from another worker's queue
+* Jobs submitted from inside a job go on the current worker's own queue
+*/
+class ThreadPool
+{
+private:
+	struct WorkerQueue
+	{
+		std::mutex mutex;
+		std::deque<std::function<void()>> jobs;
+	};
+
+	std::vector<std::thread> m_threads;
+	std::vector<WorkerQueue*> m_queues;
+
+	// jobs sitting in queues, and jobs submitted but not finished
+	std::atomic<int> m_queued;
+	std::atomic<int> m_pending;
+	std::atomic<int> m_next_queue;
+	bool m_stopping = false;
+
+	// idle workers and wait() sleep on these
+	std::mutex m_sleep_mutex;
+	std::condition_variable m_work_available;
+	std::condition_variable m_all_done;
+
+	void worker_loop(int worker);
+	bool pop_job(int worker, std::function<void()>& job);
+
+public:
+	// thread_count 0 means one thread per core
+	ThreadPool(int thread_count = 0);
+	~ThreadPool();
+
+	void submit(std::function<void()> job);
+	void wait();
+
+	int const get_thread_count() const { return (int)m_threads.size(); }
+};
@@ -0,0 +1,209 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vector>
+#include "TilemapRenderer.h"
+#include "RenderState.h"
+
+// update_tiles sends the whole rectangle around the edits while it's at most this many texels per edit
+const long MAX_UPLOAD_TEXELS_PER_EDIT = 16;
+
+/*
+* Uploads the map's tile ids and sets the uniforms that never change -- call
+* once the GL context exists, in place of Map::build
+*
+* @param program, the SHADERPROGRAM loaded from the tilemap shaders
+* @param map, the level to draw
+*/
+void TilemapRenderer::initialise(ShaderProgram* program, const Map& map)
+{
+	m_map_width = map.get_width();
+	m_map_height = map.get_height();
+	m_tile_set_texture = map.get_texture_id();
+
+	float tile_size = map.get_tile_size();
+	m_left = -(tile_size / 2);
+	m_top = (tile_size / 2);
+	m_right = m_left + tile_size * m_map_width;
+	m_bottom = m_top - tile_size * m_map_height;
+
+	// rows past the texture size limit are continued on the next texel row
+	GLint max_size = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+	long tile_total = (long)m_map_width * m_map_height;
+	m_tile_data_width = std::min(m_map_width, (int)max_size);
+	int tile_data_height = (int)((tile_total + m_tile_data_width - 1) / m_tile_data_width);
+
+	// the folded layout is the map's own row-major order, padded out to whole rows
+	std::vector<GLuint> tile_data((size_t)m_tile_data_width * tile_data_height, 0);
+	std::copy(map.get_level_data(), map.get_level_data() + tile_total, tile_data.begin());
+
+	glGenTextures(1, &m_tile_data_texture);
+	glActiveTexture(GL_TEXTURE0 + m_tile_data_unit);
+	glBindTexture(GL_TEXTURE_2D, m_tile_data_texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, m_tile_data_width, tile_data_height, 0,
+		GL_RED_INTEGER, GL_UNSIGNED_INT, tile_data.data());
+
+	// integer textures can't be filtered
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glActiveTexture(GL_TEXTURE0);
+
+	GLuint program_id = program->get_program_id();
+	g_render_state.use_program(program_id);
+	glUniform1i(glGetUniformLocation(program_id, "diffuse"), 0);
+	glUniform1i(glGetUniformLocation(program_id, "tileData"), m_tile_data_unit);
+	glUniform2f(glGetUniformLocation(program_id, "mapOrigin"), m_left, m_top);
+	glUniform1f(glGetUniformLocation(program_id, "tileSize"), tile_size);
+	glUniform1i(glGetUniformLocation(program_id, "mapWidth"), m_map_width);
+	glUniform1i(glGetUniformLocation(program_id, "tileDataWidth"), m_tile_data_width);
+	glUniform2i(glGetUniformLocation(program_id, "tileSetCount"), map.get_tile_count_x(), map.get_tile_count_y());
+}
+
+void TilemapRenderer::shutdown()
+{
+	glDeleteTextures(1, &m_tile_data_texture);
+	m_tile_data_texture = 0;
+}
+
+/*
+* Draws the part of the map the camera can see as one quad
+*
+* @param program, the SHADERPROGRAM loaded from the tilemap shaders
+* @param view_matrix, the camera used this frame
+* @param projection_matrix, the projection used this frame
+*/
+void TilemapRenderer::render(ShaderProgram* program, glm::mat4 const& view_matrix, glm::mat4 const& projection_matrix)
+{
+	ViewRect view = camera_view_rect(view_matrix, projection_matrix);
+
+	// only the overlap with the map -- the shader never reads outside the level
+	float left = std::max(view.left, m_left);
+	float right = std::min(view.right, m_right);
+	float top = std::min(view.top, m_top);
+	float bottom = std::max(view.bottom, m_bottom);
+	if (left >= right || bottom >= top) return;
+
+	float vertices[] = {
+		left, top,
+		left, bottom,
+		right, bottom,
+		left, top,
+		right, bottom,
+		right, top
+	};
+
+	g_render_state.use_program(program->get_program_id());
+	program->set_view_matrix(view_matrix);
+	program->set_projection_matrix(projection_matrix);
+
+	// this shader has no texCoord -- whatever the other programs left on must go
+	GLuint position_attribute = program->get_position_attribute();
+	g_render_state.disable_other_attributes(RenderState::attribute_bit(position_attribute));
+	glVertexAttribPointer(position_attribute, 2, GL_FLOAT, false, 0, vertices);
+	g_render_state.enable_attribute(position_attribute);
+
+	// the tile ids sit on their own unit, so the tracker's unit 0 binding stays true
+	glActiveTexture(GL_TEXTURE0 + m_tile_data_unit);
+	glBindTexture(GL_TEXTURE_2D, m_tile_data_texture);
+	glActiveTexture(GL_TEXTURE0);
+	g_render_state.bind_texture(m_tile_set_texture);
+
+	glDrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+/*
+* Changes one tile on the GPU -- a single texel write, nothing is rebuilt
+*
+* @param tile_x, tile_y, the tile's column and row in the map
+* @param tile, the new tile id, 0 for air
+*/
+void TilemapRenderer::set_tile(int tile_x, int tile_y, unsigned int tile)
+{
+	if (tile_x < 0 || tile_x >= m_map_width || tile_y < 0 || tile_y >= m_map_height) return;
+
+	long index = (long)tile_y * m_map_width + tile_x;
+	GLuint texel = tile;
+
+	glActiveTexture(GL_TEXTURE0 + m_tile_data_unit);
+	glBindTexture(GL_TEXTURE_2D, m_tile_data_texture);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, (GLint)(index % m_tile_data_width), (GLint)(index / m_tile_data_width),
+		1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, &texel);
+	glActiveTexture(GL_TEXTURE0);
+}
+
+/*
+* Writes every tile Map::set_tile changed since the last call, then clears the
+* map's dirty list -- the texture counterpart of Map::update_mesh
+* The edits go up together under one bind: the rectangle around them in a single
+* upload while it's mostly dirty tiles, otherwise one span per texel row
+* The folded texture is the map's own row-major order, so both read straight
+* out of the level data
+*
+* @param map, the level this renderer was initialised with
+*/
+void TilemapRenderer::update_tiles(Map& map)
+{
+	const std::vector<int>& dirty = map.get_dirty_tiles();
+	if (dirty.empty()) return;
+
+	int first_x = m_tile_data_width, last_x = -1, first_y = INT_MAX, last_y = -1;
+	for (int index : dirty)
+	{
+		first_x = std::min(first_x, index % m_tile_data_width);
+		last_x = std::max(last_x, index % m_tile_data_width);
+		first_y = std::min(first_y, index / m_tile_data_width);
+		last_y = std::max(last_y, index / m_tile_data_width);
+	}
+
+	const unsigned int* level_data = map.get_level_data();
+	long tile_total = (long)m_map_width * m_map_height;
+	long rect_texels = (long)(last_x - first_x + 1) * (last_y - first_y + 1);
+
+	glActiveTexture(GL_TEXTURE0 + m_tile_data_unit);
+	glBindTexture(GL_TEXTURE_2D, m_tile_data_texture);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, m_tile_data_width);
+
+	// the rectangle's last texel can land in the padding after the final tile -- nothing to read there
+	if (rect_texels <= (long)dirty.size() * MAX_UPLOAD_TEXELS_PER_EDIT
+		&& (long)last_y * m_tile_data_width + last_x < tile_total)
+	{
+		glTexSubImage2D(GL_TEXTURE_2D, 0, first_x, first_y, last_x - first_x + 1, last_y - first_y + 1,
+			GL_RED_INTEGER, GL_UNSIGNED_INT, level_data + (size_t)first_y * m_tile_data_width + first_x);
+	}
+	else
+	{
+		m_sorted_dirty.assign(dirty.begin(), dirty.end());
+		std::sort(m_sorted_dirty.begin(), m_sorted_dirty.end());
+		for (size_t i = 0; i < m_sorted_dirty.size(); )
+		{
+			// every edit on this texel row -- from the first to the last of them
+			int row = m_sorted_dirty[i] / m_tile_data_width;
+			size_t end = i;
+			while (end + 1 < m_sorted_dirty.size() && m_sorted_dirty[end + 1] / m_tile_data_width == row) end++;
+
+			int span_begin = m_sorted_dirty[i] % m_tile_data_width;
+			int span_end = m_sorted_dirty[end] % m_tile_data_width;
+			glTexSubImage2D(GL_TEXTURE_2D, 0, span_begin, row, span_end - span_begin + 1, 1,
+				GL_RED_INTEGER, GL_UNSIGNED_INT, level_data + m_sorted_dirty[i]);
+			i = end + 1;
+		}
+	}
+
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glActiveTexture(GL_TEXTURE0);
+	map.clear_dirty_tiles();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "ShaderProgram.h"
+#include "Map.h"
+
+/*
+* Shader driven alternative to the MAP's tile mesh, drawn with shaders/vertex_tilemap.glsl
+* and shaders/fragment_tilemap.glsl. The level data lives on the GPU as an integer
+* texture, one texel per tile, and each frame is a single quad over the visible part
+* of the map -- the fragment shader looks up the tile id and samples the tile set.
+* Changing a tile is one texel write instead of a mesh rebuild (needs GL 3.0)
+*
+* usage: initialise(program, map) once -> render(program, view, projection) each frame
+*/
+class TilemapRenderer
+{
+private:
+	GLuint m_tile_data_texture = 0;
+	GLuint m_tile_set_texture = 0;
+
+	int m_map_width = 0;
+	int m_map_height = 0;
+	int m_tile_data_width = 0; // texels per row -- wide maps are folded onto more rows
+
+	// world space edges of the map
+	float m_left = 0.0f, m_right = 0.0f, m_top = 0.0f, m_bottom = 0.0f;
+
+	GLint m_tile_data_unit = 1; // texture unit for the tile ids, unit 0 keeps the tile set
+
+	std::vector<int> m_sorted_dirty; // update_tiles scratch, kept so flushing edits doesn't allocate
+
+public:
+	void initialise(ShaderProgram* program, const Map& map);
+	void shutdown();
+
+	void render(ShaderProgram* program, glm::mat4 const& view_matrix, glm::mat4 const& projection_matrix);
+	void set_tile(int tile_x, int tile_y, unsigned int tile);
+	void update_tiles(Map& map);
+
+	// GETTERS
+	GLuint const get_tile_data_texture() const { return m_tile_data_texture; };
+	int    const get_tile_data_width()   const { return m_tile_data_width; };
+};
@@ -0,0 +1,100 @@
+/**
+* Author: Vitoria Tullo
+* Assignment: Rise of the AI
+* Date due: 2023-11-18, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <chrono>
+#include "WorldBatch.h"
+
+// ticks a job runs before handing the world back to the pool
+const long TICKS_PER_CHUNK = 600;
+
+/*
+* WorldBatch Constructor
+* Builds one level 1 world per config and applies its enemy tuning
+*
+* @param configs, one entry per world
+*/
+WorldBatch::WorldBatch(const std::vector<WorldConfig>& configs)
+{
+	m_configs = configs;
+	m_worlds.resize(configs.size());
+	m_outcomes.resize(configs.size());
+
+	for (size_t world = 0; world < m_worlds.size(); world++)
+	{
+		GameState& state = m_worlds[world];
+		initialise_game_state(state, 0, configs[world].seed);
+
+		for (int i = 0; i < state.enemy_count; ++i)
+		{
+			state.enemies[i].set_speeds(configs[world].walk_speed, configs[world].sprint_speed, configs[world].sneak_speed);
+			state.enemies[i].ability_cooldown = configs[world].ability_cooldown;
+			state.enemies[i].ability_timer = configs[world].ability_cooldown;
+		}
+	}
+}
+
+WorldBatch::~WorldBatch()
+{
+	for (GameState& state : m_worlds) shutdown_game_state(state);
+}
+
+/*
+* Steps one world for up to TICKS_PER_CHUNK ticks
+* Retires it once the game is over or it runs out of ticks,
+* otherwise queues the next chunk
+*
+* @param pool, the pool this job is running on
+* @param world, index of the world to step
+*/
+void WorldBatch::step_chunk(ThreadPool* pool, int world)
+{
+	GameState& state = m_worlds[world];
+	WorldOutcome& outcome = m_outcomes[world];
+	long max_ticks = m_configs[world].max_ticks;
+
+	for (long tick = 0; tick < TICKS_PER_CHUNK; tick++)
+	{
+		if (is_game_over(state) || outcome.ticks >= max_ticks)
+		{
+			outcome.player_dead = state.player->is_dead;
+			outcome.enemies_dead = !outcome.player_dead && is_game_over(state);
+			outcome.timed_out = !is_game_over(state);
+			outcome.state_hash = hash_game_state(state);
+			return;
+		}
+
+		step_game_state(state);
+		outcome.ticks++;
+	}
+
+	pool->submit([this, pool, world] { step_chunk(pool, world); });
+}
+
+/*
+* Steps every world until it is over or reaches its max_ticks
+*
+* @param thread_count, number of worker threads -- 0 uses every core
+*/
+void WorldBatch::run(int thread_count)
+{
+	ThreadPool pool(thread_count);
+
+	auto start = std::chrono::steady_clock::now();
+	for (int world = 0; world < (int)m_worlds.size(); world++)
+	{
+		pool.submit([this, &pool, world] { step_chunk(&pool, world); });
+	}
+	pool.wait();
+	auto end = std::chrono::steady_clock::now();
+
+	m_seconds = std::chrono::duration<double>(end - start).count();
+	m_total_ticks = 0;
+	for (const WorldOutcome& outcome : m_outcomes) m_total_ticks += outcome.ticks;
+}
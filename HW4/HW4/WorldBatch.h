@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include "GameState.h"
+#include "ThreadPool.h"
+
+// per-world tuning for a batch run
+struct WorldConfig
+{
+	float walk_speed = 0.5f;
+	float sprint_speed = 2.0f;
+	float sneak_speed = 0.25f;
+	float ability_cooldown = 2.0f;
+
+	long max_ticks = 60 * 60 * 5; // five minutes of game time
+	uint64_t seed = DEFAULT_SEED;
+};
+
+// how a world ended
+struct WorldOutcome
+{
+	long ticks = 0;
+	bool player_dead = false;
+	bool enemies_dead = false; // every enemy
+	bool timed_out = false;
+	uint64_t state_hash = 0; // hash_game_state when the world retired
+};
+
+/*
+* Owns N independent copies of level 1 and steps them to completion in parallel
+* Each world is stepped in chunks of ticks on a work-stealing THREADPOOL --
+* a chunk that doesn't finish its world queues the next one, so long worlds
+* spread over idle cores and finished worlds drop out straight away
+*/
+class WorldBatch
+{
+private:
+	std::vector<WorldConfig> m_configs;
+	std::vector<GameState>   m_worlds;
+	std::vector<WorldOutcome> m_outcomes;
+
+	double m_seconds = 0.0;
+	long   m_total_ticks = 0;
+
+	void step_chunk(ThreadPool* pool, int world);
+
+public:
+	WorldBatch(const std::vector<WorldConfig>& configs);
+	~WorldBatch();
+
+	// the worlds own their maps and entities, a copy would free them twice
+	WorldBatch(const WorldBatch&) = delete;
+	WorldBatch& operator=(const WorldBatch&) = delete;
+
+	// thread_count 0 uses every core
+	void run(int thread_count = 0);
+
+	// GETTERS
+	int    const get_world_count()      const { return (int)m_worlds.size(); }
+	long   const get_total_ticks()      const { return m_total_ticks; }
+	double const get_seconds()          const { return m_seconds; }
+	double const get_ticks_per_second() const { return m_seconds > 0.0 ? m_total_ticks / m_seconds : 0.0; }
+
+	const std::vector<WorldOutcome>& get_outcomes() const { return m_outcomes; }
+	const WorldConfig& get_config(int world)         const { return m_configs[world]; }
+	const GameState&   get_world(int world)          const { return m_worlds[world]; }
+};
@@ -12,10 +12,6 @@
 #define STB_IMAGE_IMPLEMENTATION
 #define LOG(argument) std::cout << argument << '\n'
 #define GL_GLEXT_PROTOTYPES 1
-#define FIXED_TIMESTEP 0.0166666f
-#define LEVEL1_WIDTH 14
-#define LEVEL1_HEIGHT 5
-#define ENEMY_COUNT 4
 
 #ifdef _WINDOWS
 #include <GL/glew.h>
@@ -30,19 +26,24 @@
 #include "stb_image.h"
 #include "cmath"
 #include <ctime>
+#include <chrono>
 #include <vector>
+#include <string>
 #include <cstdlib>
 #include "Entity.h"
 #include "Map.h"
-
-struct GameState
-{
-	Entity* player;
-	Entity* enemies;
-	Entity* weapons;
-
-	Map* map;
-};
+#include "GameState.h"
+#include "InputLog.h"
+#include "SpriteBatch.h"
+#include "InstancedSprites.h"
+#include "TilemapRenderer.h"
+#include "TextureCache.h"
+#include "TextureAtlas.h"
+#include "TextMesh.h"
+#include "ThreadPool.h"
+#include "AssetArchive.h"
+#include "RenderState.h"
+#include "Profiler.h"
 
 // CONSTS
 // window dimensions + viewport
@@ -62,7 +63,12 @@ BG_OPACITY = 1.0f;
 
 // shaders
 const char V_SHADER_PATH[] = "shaders/vertex_textured.glsl",
-F_SHADER_PATH[] = "shaders/fragment_textured.glsl";
+F_SHADER_PATH[] = "shaders/fragment_textured.glsl",
+V_INSTANCED_SHADER_PATH[] = "shaders/vertex_instanced.glsl",
+V_MAP_SHADER_PATH[] = "shaders/vertex_map.glsl",
+F_MAP_SHADER_PATH[] = "shaders/fragment_map.glsl",
+V_TILEMAP_SHADER_PATH[] = "shaders/vertex_tilemap.glsl",
+F_TILEMAP_SHADER_PATH[] = "shaders/fragment_tilemap.glsl";
 
 // texture filepaths
 // ENTITIES
@@ -77,10 +83,15 @@ MAP_TILESET_FILEPATH[] = "Tileset_Placeholder.png",
 // FONT
 FONT_FILEPATH[] = "font.png";
 
-// texture constants
-const int NUMBER_OF_TEXTURES = 1;
-const GLint LEVEL_OF_DETAIL = 0;
-const GLint TEXTURE_BORDER = 0;
+// pre-decoded textures and shaders made by HW4Pack -- loose files are used if it's missing
+const char ASSET_ARCHIVE_FILEPATH[] = "assets.pak";
+
+// every image the first frame needs -- decoded together at startup
+const char* const STARTUP_TEXTURES[] = { MAP_TILESET_FILEPATH, FONT_FILEPATH };
+
+// character sprites -- packed into one atlas so entities share a texture
+const char* const SPRITE_TEXTURES[] = { BONNIE_FILEPATH, CHICA_FILEPATH, FOXY_FILEPATH,
+	FREDDY_FILEPATH, PLAYER_FILEPATH, TRAP_FILEPATH };
 
 // math + physics constants
 const float MILLISECONDS_IN_SECOND = 1000.0;
@@ -97,32 +108,62 @@ SDL_Window* g_display_window;
 bool g_game_is_running = true;
 
 ShaderProgram g_shader_program;
+ShaderProgram g_map_program; // tile mesh -- merged quads repeat their tile
+SpriteBatch g_sprite_batch; // every entity sprite, drawn together once a frame
+
+// --instanced draws the entities with one instanced call per texture instead (needs GL 3.3)
+bool g_instanced = false;
+ShaderProgram g_instanced_program;
+InstancedSprites g_instanced_sprites;
+
+// --tile-shader draws the map as one quad over a texture of tile ids instead of the tile mesh (needs GL 3.0)
+bool g_tile_shader = false;
+ShaderProgram g_tilemap_program;
+TilemapRenderer g_tilemap_renderer;
+
+// TEXTURES -- each file is loaded once, the level's handles are released on shutdown
+TextureCache g_textures;
+AssetArchive g_asset_archive;
+TextureAtlas g_sprite_atlas;
+std::vector<TextureHandle> g_level_textures;
+GLuint g_font_texture_id;
+
+// TEXT -- laid out once into GPU buffers, only redone if the string changes
+GlyphTable g_glyphs;
+TextMesh g_lose_text;
+TextMesh g_win_text;
+
+// --serial-assets decodes on the main thread after the window is up, like before
+// the loader -- kept so the time to first frame can be compared
+bool g_serial_assets = false;
+std::chrono::steady_clock::time_point g_start_time;
+bool g_first_frame_shown = false;
 glm::mat4 g_view_matrix, g_projection_matrix;
 
 float g_previous_ticks = 0.0f;
 float g_accumulator = 0.0f;
 
-// weapon variables
-bool trap_placed = false;
+// this frame's controls, applied on every fixed step
+PlayerInput g_input;
 
-unsigned int LEVEL_1_DATA[] =
-{
-	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-	1, 1, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 1, 1,
-	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-	3, 3, 3, 3, 3, 3, 3, 3, 2, 2, 2, 2, 2, 2
-};
+// --record <file> saves every step's input on shutdown
+// --replay <file> plays a recording back in real time instead of the keyboard
+InputLog g_input_log;
+std::string g_record_filepath;
+bool g_replaying = false;
+long g_replay_tick = 0;
+
+// P writes the profiler's trace to g_trace_filepath -- --trace <file> also writes it on shutdown
+// only records anything when built with HW4_PROFILE
+std::string g_trace_filepath = "trace.json";
+bool g_trace_on_shutdown = false;
 
 // helpers
 GLuint load_texture(const char* filepath);
 void init_platform(Entity& entity, glm::vec3 position,
 	EntityType type, GLuint& texture);
-void init_enemy(Entity& enemy, AIType animatronic,
-	const char texture_name[], glm::vec3 position);
-void draw_text(ShaderProgram* program, GLuint font_texture_id, std::string text,
-	float screen_size, float spacing, glm::vec3 position);
 // for game program
+bool parse_arguments(int argc, char* argv[]);
 void initialise();
 void process_input();
 void update();
@@ -132,10 +173,15 @@ void shutdown();
 //  GAME LOOP  //
 int main(int argc, char* argv[])
 {
+	g_start_time = std::chrono::steady_clock::now();
+	profile_name_thread("main");
+	if (!parse_arguments(argc, argv)) return 1;
+
 	initialise(); // initailize all game objects and code -- runs ONCE
 
 	while (g_game_is_running)
 	{
+		PROFILE_SCOPE("frame");
 		process_input(); // get input from player
 		update(); // update the game state, run every frame
 		render(); // show the game state (after update to show changes in game state)
@@ -146,62 +192,77 @@ int main(int argc, char* argv[])
 }
 
 /*
-* Loads a texture to be used for each sprite
+* Gets a texture to be used for each sprite from the cache
+* The level keeps the reference until shutdown
 * 
 * @param filepath, an array of chars that represents the text name
   of the filepath of the texture for the sprite
 */
 GLuint load_texture(const char* filepath)
 {
-	// Load image file from filepath
-	int width, height, number_of_components;
-	unsigned char* image = stbi_load(filepath, &width, &height, &number_of_components, STBI_rgb_alpha);
-
-	// Throw error if no image found at filepath
-	if (image == NULL)
-	{
-		LOG(" Unable to load image. Make sure the path is correct.");
-		assert(false);
-	}
-
-	// Generate and bind texture ID to image
-	GLuint textureID;
-	glGenTextures(NUMBER_OF_TEXTURES, &textureID);
-	glBindTexture(GL_TEXTURE_2D, textureID);
-	glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_RGBA, width, height, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, image);
-
-	// Setting up texture filter parameters
-	// NEAREST better for pixel art
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-	// Release from memory and return texture id
-	stbi_image_free(image);
-
-	return textureID;
+	TextureHandle handle = g_textures.acquire(filepath);
+	g_level_textures.push_back(handle);
+	return g_textures.get_texture_id(handle);
 }
 
 /*
-* Initialises an ENEMY ENTITY object
+* Reads the recording options
 * 
-* @param enemy, the ENEMY ENTITY object
-* @param AITYPE, what animatronic they are
-* @param texture_name[], the name of the sprite they have
-* @param position, the position the enemy is going to spawn at
+* @param argc, argument count from main
+* @param argv, arguments from main
+*
+* @return false if the arguments are wrong or the replay can't be read
 */
-void init_enemy(Entity& enemy, AIType animatronic, 
-	const char texture_name[], glm::vec3 position)
+bool parse_arguments(int argc, char* argv[])
 {
-	enemy.set_entity_type(ENEMY);
-	enemy.set_ai_type(animatronic);
-	enemy.m_texture_id = load_texture(texture_name);
-	enemy.set_position(position);
-	enemy.set_movement(glm::vec3(0.0f));
-	enemy.set_speeds(.50f, 2.0f, 0.25f);
-	enemy.set_acceleration(glm::vec3(0.0f, -9.81f, 0.0f));
-	enemy.set_ai_state(IDLE);
+	for (int i = 1; i < argc; i++)
+	{
+		std::string option = argv[i];
+		if (option == "--serial-assets")
+		{
+			g_serial_assets = true;
+			continue;
+		}
+		if (option == "--instanced")
+		{
+			g_instanced = true;
+			continue;
+		}
+		if (option == "--tile-shader")
+		{
+			g_tile_shader = true;
+			continue;
+		}
+		if (i + 1 >= argc)
+		{
+			LOG("Usage: HW4 [--record <file>] [--replay <file>] [--trace <file>] [--serial-assets] [--instanced] [--tile-shader]");
+			return false;
+		}
+
+		if (option == "--record") g_record_filepath = argv[++i];
+		else if (option == "--trace")
+		{
+			g_trace_filepath = argv[++i];
+			g_trace_on_shutdown = true;
+		}
+		else if (option == "--replay")
+		{
+			if (!g_input_log.load(argv[++i]))
+			{
+				LOG("Unable to read input log " << argv[i]);
+				return false;
+			}
+			g_replaying = true;
+		}
+		else
+		{
+			LOG("Usage: HW4 [--record <file>] [--replay <file>] [--trace <file>] [--serial-assets] [--instanced] [--tile-shader]");
+			return false;
+		}
+	}
+
+	if (!g_replaying) g_input_log.clear(DEFAULT_SEED);
+	return true;
 }
 
 /*
@@ -209,6 +270,32 @@ void init_enemy(Entity& enemy, AIType animatronic,
 */
 void initialise()
 {
+	PROFILE_SCOPE("initialise");
+	if (g_asset_archive.open(ASSET_ARCHIVE_FILEPATH))
+	{
+		g_textures.set_archive(&g_asset_archive);
+		g_sprite_atlas.set_archive(&g_asset_archive);
+		g_shader_program.set_archive(&g_asset_archive);
+		g_instanced_program.set_archive(&g_asset_archive);
+		g_map_program.set_archive(&g_asset_archive);
+		g_tilemap_program.set_archive(&g_asset_archive);
+	}
+
+	// TEXTURES -- decoding starts on worker threads before the window, so it
+	// overlaps SDL and GL start-up. The uploads happen below once GL exists
+	for (const char* filepath : SPRITE_TEXTURES) g_sprite_atlas.add(filepath);
+
+	ThreadPool* asset_pool = nullptr;
+	if (!g_serial_assets)
+	{
+		asset_pool = new ThreadPool();
+		for (const char* filepath : STARTUP_TEXTURES)
+		{
+			g_level_textures.push_back(g_textures.acquire_async(filepath, *asset_pool));
+		}
+		g_sprite_atlas.decode_async(*asset_pool);
+	}
+
 	// create window
 	SDL_Init(SDL_INIT_VIDEO);
 	g_display_window = SDL_CreateWindow("HW 4!!!!!!",
@@ -234,33 +321,56 @@ void initialise()
 	g_shader_program.set_view_matrix(g_view_matrix);
 	g_view_matrix = glm::translate(g_view_matrix, glm::vec3(-5.0f, 0.75f, 0.0f));
 
-	glUseProgram(g_shader_program.get_program_id());
+	g_render_state.use_program(g_shader_program.get_program_id());
+	g_sprite_batch.initialise();
+
+	if (g_instanced)
+	{
+		g_instanced_program.load(V_INSTANCED_SHADER_PATH, F_SHADER_PATH);
+		g_instanced_program.set_projection_matrix(g_projection_matrix);
+		g_instanced_sprites.initialise(&g_instanced_program);
+	}
 
 	glClearColor(BG_RED, BG_BLUE, BG_GREEN, BG_OPACITY);
 
-	// MAP
+	// upload each image as its decode finishes -- load_texture below then hits the cache
+	g_textures.finish_loading();
+	delete asset_pool;
+
+	// the pool is finished with, so every sprite is decoded -- pack them into pages
+	g_sprite_atlas.build();
+
+	// GAME STATE -- simulation side, no textures yet
 	GLuint map_texture_id = load_texture(MAP_TILESET_FILEPATH);
-	g_state.map = new Map(LEVEL1_WIDTH, LEVEL1_HEIGHT, LEVEL_1_DATA, map_texture_id, 1.0f, 3, 1);
+	initialise_game_state(g_state, map_texture_id, g_input_log.get_seed());
+	if (g_tile_shader)
+	{
+		g_tilemap_program.load(V_TILEMAP_SHADER_PATH, F_TILEMAP_SHADER_PATH);
+		g_tilemap_renderer.initialise(&g_tilemap_program, *g_state.map);
+	}
+	else
+	{
+		g_map_program.load(V_MAP_SHADER_PATH, F_MAP_SHADER_PATH);
+		g_state.map->build();
+	}
 
-	// ENEMIES
-	g_state.enemies = new Entity[ENEMY_COUNT];
-	init_enemy(g_state.enemies[0], BONNIE, BONNIE_FILEPATH, glm::vec3(7.75f, 0.0f, 0.0f));
-	init_enemy(g_state.enemies[1], CHICA, CHICA_FILEPATH, glm::vec3(7.75f, -2.75f, 0.0f));
-	init_enemy(g_state.enemies[2], FOXY, FOXY_FILEPATH, glm::vec3(12.0f, -2.75f, 0.0f));
-	init_enemy(g_state.enemies[3], FREDDY, FREDDY_FILEPATH, glm::vec3(0.0f, 0.0f, 0.0f));
+	// ENEMIES -- same slots as initialise_game_state
+	g_state.enemies[0].m_sprite = g_sprite_atlas.find(BONNIE_FILEPATH);
+	g_state.enemies[1].m_sprite = g_sprite_atlas.find(CHICA_FILEPATH);
+	g_state.enemies[2].m_sprite = g_sprite_atlas.find(FOXY_FILEPATH);
+	g_state.enemies[3].m_sprite = g_sprite_atlas.find(FREDDY_FILEPATH);
 
 	// PLAYER
-	g_state.player = new Entity();
-	g_state.player->set_entity_type(PLAYER);
-	g_state.player->set_position(glm::vec3(3.0f, -3.0f, 0.0f));
-	g_state.player->set_movement(glm::vec3(0.0f, 0.0f, 0.0f));
-	g_state.player->set_speeds(1.5f, 4.0f, 0.5f);
-	g_state.player->set_acceleration(glm::vec3(0.0f, -9.81f, 0.0f)); // gravity
-	g_state.player->m_texture_id = load_texture(PLAYER_FILEPATH);
-	g_state.player->is_facing_right = true;
-
-	// WEAPON
-	g_state.weapons = new Entity[2];
+	g_state.player->m_sprite = g_sprite_atlas.find(PLAYER_FILEPATH);
+
+	// WEAPON -- only drawn once the trap is placed
+	g_state.weapons[0].m_sprite = g_sprite_atlas.find(TRAP_FILEPATH);
+
+	// FONT -- only drawn for the win/lose text, but loaded up front so render never decodes
+	g_font_texture_id = load_texture(FONT_FILEPATH);
+	g_glyphs.build(FONTBANK_SIZE);
+	g_lose_text.set_text(g_glyphs, "you lose", 0.5f, -0.2f);
+	g_win_text.set_text(g_glyphs, "you win", 0.5f, -0.2f);
 
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -268,10 +378,13 @@ void initialise()
 
 // Reads all the inputs on player's machine
 // This includes keyboard, mouse, and window close
+// Player controls go into g_input, which the fixed steps in update() consume
 void process_input()
 {
-	// reset player movement vector
-	g_state.player->set_movement(glm::vec3(0.0f));
+	PROFILE_SCOPE("process_input");
+	// reset player movement -- jump stays set until a step uses it
+	g_input.direction = 0;
+	g_input.place_trap = false;
 
 	SDL_Event event;
 	// check if game is quit
@@ -293,10 +406,13 @@ void process_input()
 
 			case SDLK_SPACE:
 				// Jump
-				if (g_state.player->m_collided_bottom)
-				{
-					g_state.player->m_is_jumping = true;
-				}
+				g_input.jump = true;
+				break;
+
+			case SDLK_p:
+				// Dump what the profiler has recorded so far
+				if (write_profile_trace(g_trace_filepath.c_str())) LOG("Wrote trace " << g_trace_filepath);
+				else LOG("No trace written -- build with HW4_PROFILE");
 				break;
 			}
 		}
@@ -304,57 +420,26 @@ void process_input()
 
 	const Uint8* key_state = SDL_GetKeyboardState(NULL);
 
-	if (key_state[SDL_SCANCODE_A])
+	if (key_state[SDL_SCANCODE_A] || key_state[SDL_SCANCODE_D])
 	{
 		// If holding either shift enter into sprint mode
 		if (key_state[SDL_SCANCODE_LSHIFT] || key_state[SDL_SCANCODE_RSHIFT])
 		{
-			g_state.player->set_movement_state(SPRINT);
+			g_input.movement_state = SPRINT;
 		}
 		// If holding either control enter into sprint mode
 		if (key_state[SDL_SCANCODE_LCTRL] || key_state[SDL_SCANCODE_RCTRL])
 		{
-			g_state.player->set_movement_state(SNEAK);
+			g_input.movement_state = SNEAK;
 		}
-		else g_state.player->set_movement_state(WALK); // otherwise normal speed
+		else g_input.movement_state = WALK; // otherwise normal speed
 
-		g_state.player->move_left();
-		g_state.player->is_facing_right = false;
-	}
-	else if (key_state[SDL_SCANCODE_D])
-	{
-		// If holding either shift enter into sprint mode
-		if (key_state[SDL_SCANCODE_LSHIFT] || key_state[SDL_SCANCODE_RSHIFT])
-		{
-			g_state.player->set_movement_state(SPRINT);
-		}
-		// If holding either control enter into sprint mode
-		if (key_state[SDL_SCANCODE_LCTRL] || key_state[SDL_SCANCODE_RCTRL])
-		{
-			g_state.player->set_movement_state(SNEAK);
-		}
-		else g_state.player->set_movement_state(WALK); // otherwise normal speed
-
-		g_state.player->is_facing_right = true;
-		g_state.player->move_right();
+		g_input.direction = key_state[SDL_SCANCODE_A] ? -1 : 1;
 	}
 	if (key_state[SDL_SCANCODE_F])
 	{
-		if (!trap_placed)
-		{
-			trap_placed = true;
-			// Trap Placement
-			g_state.weapons[0].set_entity_type(WEAPON);
-			g_state.weapons[0].m_texture_id = load_texture(TRAP_FILEPATH);
-			g_state.weapons[0].set_movement(glm::vec3(0.0f));
-			g_state.weapons[0].set_speeds(0.0f, 0.0f, 0.0f);
-			g_state.weapons[0].set_acceleration(glm::vec3(0.0f));
-		}
-		if (g_state.player->is_facing_right)
-		{
-			g_state.weapons[0].set_position(g_state.player->get_position() + glm::vec3(1.0f, 0.0f, 0.0f));
-		}
-		else g_state.weapons[0].set_position(g_state.player->get_position() + glm::vec3(-1.0f, 0.0f, 0.0f));
+		// Trap Placement
+		g_input.place_trap = true;
 	}
 }
 
@@ -363,36 +448,39 @@ void process_input()
 */
 void update()
 {
+	PROFILE_SCOPE("update");
 	float ticks = (float)SDL_GetTicks() / MILLISECONDS_IN_SECOND;
 	float delta_time = ticks - g_previous_ticks;
 	g_previous_ticks = ticks;
 
-	delta_time += g_accumulator;
+	// fixed-timestep loop lives in GameState.cpp so it can run headless
+	int steps;
+	if (g_replaying) steps = replay_game_state(g_state, g_input_log, g_replay_tick, delta_time, g_accumulator);
+	else steps = update_game_state(g_state, g_input, delta_time, g_accumulator,
+		g_record_filepath.empty() ? nullptr : &g_input_log);
+	if (steps == 0) return;
 
-	if (delta_time < FIXED_TIMESTEP)
+	g_view_matrix = glm::mat4(1.0f);
+	g_view_matrix = glm::translate(g_view_matrix, glm::vec3(-g_state.player->get_position().x, 0.75f, 0.0f));
+}
+
+/*
+* Queues the player, the trap and the enemies
+*
+* @param sprites, a SPRITEBATCH or INSTANCEDSPRITES between begin() and end()
+*/
+template <typename SpriteRenderer>
+void draw_entities(SpriteRenderer& sprites)
+{
+	g_state.player->draw(sprites);
+	if (g_state.trap_placed)
 	{
-		g_accumulator = delta_time;
-		return;
+		g_state.weapons[0].draw(sprites);
 	}
-
-	while (delta_time >= FIXED_TIMESTEP)
+	for (int i = 0; i < g_state.enemy_count; ++i)
 	{
-		g_state.player->update(FIXED_TIMESTEP, g_state.player, g_state.player, 1, g_state.map);
-		for (size_t i = 0; i < ENEMY_COUNT; ++i)
-		{
-			g_state.enemies[i].update(FIXED_TIMESTEP, g_state.player, g_state.player, 1, g_state.map);
-		}
-		if (trap_placed)
-		{
-			g_state.weapons[0].update(FIXED_TIMESTEP, g_state.player, g_state.enemies, ENEMY_COUNT, g_state.map);
-		}
-		delta_time -= FIXED_TIMESTEP;
+		g_state.enemies[i].draw(sprites);
 	}
-
-	g_accumulator = delta_time;
-
-	g_view_matrix = glm::mat4(1.0f);
-	g_view_matrix = glm::translate(g_view_matrix, glm::vec3(-g_state.player->get_position().x, 0.75f, 0.0f));
 }
 
 /*
@@ -401,39 +489,68 @@ void update()
 */
 void render()
 {
+	PROFILE_SCOPE("render");
+	g_render_state.begin_frame();
 	g_shader_program.set_view_matrix(g_view_matrix);
 
 	glClear(GL_COLOR_BUFFER_BIT);
 
-	g_state.player->render(&g_shader_program);
-	g_state.map->render(&g_shader_program);
-	if (trap_placed)
+	// tiles changed by this frame's steps go up in one batch before the map is drawn
+	if (g_tile_shader)
 	{
-		g_state.weapons[0].render(&g_shader_program);
+		PROFILE_SCOPE("render map");
+		g_tilemap_renderer.update_tiles(*g_state.map);
+		g_tilemap_renderer.render(&g_tilemap_program, g_view_matrix, g_projection_matrix);
 	}
-	for (size_t i = 0; i < ENEMY_COUNT; ++i)
+	else
 	{
-		g_state.enemies[i].render(&g_shader_program);
+		PROFILE_SCOPE("render map");
+		g_state.map->update_mesh();
+		g_state.map->render(&g_map_program, g_view_matrix, g_projection_matrix);
+	}
+
+	if (g_instanced)
+	{
+		PROFILE_SCOPE("render sprites");
+		g_instanced_program.set_view_matrix(g_view_matrix);
+		g_instanced_sprites.begin();
+		draw_entities(g_instanced_sprites);
+		g_instanced_sprites.end(&g_instanced_program);
+	}
+	else
+	{
+		PROFILE_SCOPE("render sprites");
+		g_sprite_batch.begin();
+		draw_entities(g_sprite_batch);
+		g_sprite_batch.end(&g_shader_program);
 	}
 
 	if (g_state.player->is_dead == true)
 	{
-		draw_text(&g_shader_program, load_texture(FONT_FILEPATH), "you lose", 0.5f,
-			-0.2f, glm::vec3(g_state.player->get_position().x, 0.0f, 0.0f));
+		g_lose_text.render(&g_shader_program, g_font_texture_id, glm::vec3(g_state.player->get_position().x, 0.0f, 0.0f));
 	}
 	
 	int death_count = 0;
-	for (size_t i = 0; i < ENEMY_COUNT; ++i)
+	for (int i = 0; i < g_state.enemy_count; ++i)
 	{
 		if (g_state.enemies[i].is_dead) death_count += 1;
 	}
-	if (death_count == ENEMY_COUNT)
+	if (death_count == g_state.enemy_count)
+	{
+		g_win_text.render(&g_shader_program, g_font_texture_id, glm::vec3(g_state.player->get_position().x, 0.0f, 0.0f));
+	}
+
 	{
-		draw_text(&g_shader_program, load_texture(FONT_FILEPATH), "you win", 0.5f,
-			-0.2f, glm::vec3(g_state.player->get_position().x, 0.0f, 0.0f));
+		PROFILE_SCOPE("SDL_GL_SwapWindow");
+		SDL_GL_SwapWindow(g_display_window);
 	}
 
-	SDL_GL_SwapWindow(g_display_window);
+	if (!g_first_frame_shown)
+	{
+		g_first_frame_shown = true;
+		double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - g_start_time).count();
+		LOG("Time to first frame: " << milliseconds << " ms" << (g_serial_assets ? " (serial assets)" : ""));
+	}
 }
 
 /*
@@ -441,82 +558,38 @@ void render()
 */
 void shutdown()
 {
-	SDL_Quit();
-
-	// free from memory
-	delete g_state.enemies;
-	delete g_state.player;
-	delete g_state.map;
-}
-
-/*
-* Draws all the game's text
-* 
-* @param program, a reference to the shader program that the game is using
-* @param font_texture_id, the image that contains our font
-* @param text, the text to be rendered
-* @param screen_size, size of the game's display
-* @param spacing, spacing between characters
-* @param position, position of the text
-*/
-void draw_text(ShaderProgram* program, GLuint font_texture_id, std::string text, float screen_size, float spacing, glm::vec3 position)
-{
-	// Scale the size of the fontbank in the UV-plane
-	// We will use this for spacing and positioning
-	float width = 1.0f / FONTBANK_SIZE;
-	float height = 1.0f / FONTBANK_SIZE;
-
-	// Instead of having a single pair of arrays, we'll have a series of pairsone for each character
-	// Don't forget to include <vector>!
-	std::vector<float> vertices;
-	std::vector<float> texture_coordinates;
-
-	// For every character...
-	for (int i = 0; i < text.size(); i++) {
-		// 1. Get their index in the spritesheet, as well as their offset (i.e. their position
-		//    relative to the whole sentence)
-		int spritesheet_index = (int)text[i];  // ascii value of character
-		float offset = (screen_size + spacing) * i;
-
-		// 2. Using the spritesheet index, we can calculate our U- and V-coordinates
-		float u_coordinate = (float)(spritesheet_index % FONTBANK_SIZE) / FONTBANK_SIZE;
-		float v_coordinate = (float)(spritesheet_index / FONTBANK_SIZE) / FONTBANK_SIZE;
-
-		// 3. Inset the current pair in both vectors
-		vertices.insert(vertices.end(), {
-			offset + (-0.5f * screen_size), 0.5f * screen_size,
-			offset + (-0.5f * screen_size), -0.5f * screen_size,
-			offset + (0.5f * screen_size), 0.5f * screen_size,
-			offset + (0.5f * screen_size), -0.5f * screen_size,
-			offset + (0.5f * screen_size), 0.5f * screen_size,
-			offset + (-0.5f * screen_size), -0.5f * screen_size,
-			});
-
-		texture_coordinates.insert(texture_coordinates.end(), {
-			u_coordinate, v_coordinate,
-			u_coordinate, v_coordinate + height,
-			u_coordinate + width, v_coordinate,
-			u_coordinate + width, v_coordinate + height,
-			u_coordinate + width, v_coordinate,
-			u_coordinate, v_coordinate + height,
-			});
+	PROFILE_SCOPE("shutdown");
+	g_sprite_batch.shutdown();
+	if (g_instanced) g_instanced_sprites.shutdown();
+	if (g_tile_shader) g_tilemap_renderer.shutdown();
+
+	LOG("Textures live at shutdown: " << g_textures.get_live_count() << " (" << g_textures.get_live_bytes()
+		<< " bytes), " << g_textures.get_load_count() << " loaded");
+	LOG("Sprite atlas: " << g_sprite_atlas.get_image_count() << " sprites on " << g_sprite_atlas.get_page_count()
+		<< " page(s), " << g_sprite_atlas.get_page_bytes() << " bytes");
+	if (g_render_state.get_frame_count() > 0)
+	{
+		LOG("GL state calls per frame: " << g_render_state.get_total_issued() / g_render_state.get_frame_count()
+			<< " issued, " << g_render_state.get_total_skipped() / g_render_state.get_frame_count() << " skipped");
 	}
+	for (TextureHandle& handle : g_level_textures) g_textures.release(handle);
+	g_textures.unload_unused();
+	g_sprite_atlas.unload();
+	g_lose_text.release();
+	g_win_text.release();
+	g_state.map->release_mesh();
 
-	// 4. And render all of them using the pairs
-	glm::mat4 model_matrix = glm::mat4(1.0f);
-	model_matrix = glm::translate(model_matrix, position);
-
-	program->set_model_matrix(model_matrix);
-	glUseProgram(program->get_program_id());
-
-	glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, 0, vertices.data());
-	glEnableVertexAttribArray(program->get_position_attribute());
-	glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, 0, texture_coordinates.data());
-	glEnableVertexAttribArray(program->get_tex_coordinate_attribute());
+	SDL_Quit();
 
-	glBindTexture(GL_TEXTURE_2D, font_texture_id);
-	glDrawArrays(GL_TRIANGLES, 0, (int)(text.size() * 6));
+	if (!g_record_filepath.empty() && !g_input_log.save(g_record_filepath))
+	{
+		LOG("Unable to write input log " << g_record_filepath);
+	}
+	if (g_trace_on_shutdown && !write_profile_trace(g_trace_filepath.c_str()))
+	{
+		LOG("Unable to write trace " << g_trace_filepath << " -- build with HW4_PROFILE");
+	}
 
-	glDisableVertexAttribArray(program->get_position_attribute());
-	glDisableVertexAttribArray(program->get_tex_coordinate_attribute());
+	// free from memory
+	shutdown_game_state(g_state);
 }
\ No newline at end of file
@@ -0,0 +1,9 @@
+
+uniform sampler2D diffuse;
+varying vec2 texCoordVar;
+varying vec4 tileAtlasVar;
+
+void main() {
+    // repeat inside the one tile -- GL_REPEAT would run on into the rest of the tile set
+    gl_FragColor = texture2D(diffuse, tileAtlasVar.xy + fract(texCoordVar) * tileAtlasVar.zw);
+}
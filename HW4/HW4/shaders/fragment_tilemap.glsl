@@ -0,0 +1,28 @@
+#version 130
+
+uniform sampler2D diffuse;   // tile set
+uniform usampler2D tileData; // one tile id per texel, rows folded to fit the texture size limit
+
+uniform vec2  mapOrigin;    // world position of the map's top left corner
+uniform float tileSize;
+uniform int   mapWidth;     // tiles per map row
+uniform int   tileDataWidth; // texels per tileData row
+uniform ivec2 tileSetCount; // tiles across and down the tile set
+
+varying vec2 worldPosition;
+
+void main()
+{
+	// which tile this pixel falls in, and where inside it
+	vec2 tile = vec2(worldPosition.x - mapOrigin.x, mapOrigin.y - worldPosition.y) / tileSize;
+	ivec2 cell = ivec2(floor(tile));
+
+	int index = cell.y * mapWidth + cell.x;
+	uint id = texelFetch(tileData, ivec2(index % tileDataWidth, index / tileDataWidth), 0).r;
+
+	// EMPTY TILES/AIR ARE DENOTED AS 0
+	if (id == 0u) discard;
+
+	vec2 atlas = vec2(int(id) % tileSetCount.x, int(id) / tileSetCount.x);
+	gl_FragColor = texture2D(diffuse, (atlas + tile - vec2(cell)) / vec2(tileSetCount));
+}
@@ -0,0 +1,20 @@
+attribute vec4 position;
+attribute vec2 texCoord;
+
+// per instance -- one of each for every sprite
+attribute vec4 instanceRect;  // centre x, centre y, width, height
+attribute vec4 instanceAtlas; // u, v, width, height of the sprite in its texture
+attribute float instanceFlip; // 1 as drawn, -1 mirrored left to right
+
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+
+varying vec2 texCoordVar;
+
+void main()
+{
+	vec2 corner = instanceRect.xy + position.xy * instanceRect.zw;
+	float u = instanceFlip < 0.0 ? 1.0 - texCoord.x : texCoord.x;
+	texCoordVar = instanceAtlas.xy + vec2(u, texCoord.y) * instanceAtlas.zw;
+	gl_Position = projectionMatrix * viewMatrix * vec4(corner, 0.0, 1.0);
+}
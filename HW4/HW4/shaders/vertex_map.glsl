@@ -0,0 +1,16 @@
+attribute vec4 position;
+attribute vec2 texCoord;  // in tiles -- a merged quad counts up past 1 so its tile repeats
+attribute vec4 tileAtlas; // u, v, width, height of the tile in the tile set
+
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+
+varying vec2 texCoordVar;
+varying vec4 tileAtlasVar;
+
+void main()
+{
+	texCoordVar = texCoord;
+	tileAtlasVar = tileAtlas;
+	gl_Position = projectionMatrix * viewMatrix * position;
+}
@@ -0,0 +1,14 @@
+#version 130
+
+attribute vec4 position; // world space corner of the visible part of the map
+
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+
+varying vec2 worldPosition;
+
+void main()
+{
+	worldPosition = position.xy;
+	gl_Position = projectionMatrix * viewMatrix * vec4(position.xy, 0.0, 1.0);
+}